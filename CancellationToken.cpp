@@ -0,0 +1,66 @@
+#include "CancellationToken.h"
+
+static thread_local CancellationToken currentToken;
+
+CancellationToken CancellationToken::create(QDeadlineTimer deadline) {
+    CancellationToken token;
+    token.state = std::make_shared<State>();
+    token.state->deadline = deadline;
+    return token;
+}
+
+void CancellationToken::cancel() const {
+    if (!state) return;
+    QHash<int, std::function<void()>> callbacks;
+    {
+        QMutexLocker locker(&state->mutex);
+        if (state->cancelled) return;
+        state->cancelled = true;
+        callbacks.swap(state->callbacks);
+    }
+    for (const auto& callback : callbacks) callback();
+}
+
+bool CancellationToken::isCancelled() const {
+    if (!state) return false;
+    QMutexLocker locker(&state->mutex);
+    return state->cancelled || state->deadline.hasExpired();
+}
+
+QDeadlineTimer CancellationToken::deadline() const {
+    if (!state) return QDeadlineTimer(QDeadlineTimer::Forever);
+    QMutexLocker locker(&state->mutex);
+    return state->deadline;
+}
+
+int CancellationToken::subscribe(std::function<void()> callback) const {
+    if (!state) return 0;
+    {
+        QMutexLocker locker(&state->mutex);
+        if (!state->cancelled) {
+            int id = state->nextId++;
+            state->callbacks.insert(id, std::move(callback));
+            return id;
+        }
+    }
+    callback();
+    return 0;
+}
+
+void CancellationToken::unsubscribe(int id) const {
+    if (!state || id == 0) return;
+    QMutexLocker locker(&state->mutex);
+    state->callbacks.remove(id);
+}
+
+CancellationToken CancellationToken::current() {
+    return currentToken;
+}
+
+CancellationScope::CancellationScope(const CancellationToken& token) : previous(currentToken) {
+    currentToken = token;
+}
+
+CancellationScope::~CancellationScope() {
+    currentToken = previous;
+}
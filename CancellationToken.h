@@ -0,0 +1,56 @@
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QMutex>
+#include <functional>
+#include <memory>
+
+// Shared cancellation flag with an optional deadline. Copies refer to the same state; a default-constructed
+// token can never be cancelled. Past its deadline a token reports itself cancelled, but only explicit
+// cancel() runs the subscribers, so code that waits must also bound the wait by deadline().
+class CancellationToken {
+public:
+    CancellationToken() = default;
+    static CancellationToken create(QDeadlineTimer deadline = QDeadlineTimer(QDeadlineTimer::Forever));
+
+    void cancel() const;
+    bool isCancelled() const;
+    bool canBeCancelled() const { return state != nullptr; }
+    QDeadlineTimer deadline() const;
+
+    // Runs callback once when cancel() is called, on the cancelling thread; immediately if already cancelled
+    // (and then returns 0). Unsubscribe before anything the callback touches goes away.
+    int subscribe(std::function<void()> callback) const;
+    void unsubscribe(int id) const;
+
+    // The token of the operation the calling thread is working for; see CancellationScope.
+    static CancellationToken current();
+
+private:
+    struct State {
+        QMutex mutex;
+        bool cancelled = false;
+        QDeadlineTimer deadline;
+        int nextId = 1;
+        QHash<int, std::function<void()>> callbacks;
+    };
+    std::shared_ptr<State> state;
+};
+
+// Makes token current on this thread for the scope's lifetime. Worker lambdas open one first thing, so
+// everything they call (searches, resolution, HttpEngine requests) picks the token up without it being
+// threaded through every signature.
+class CancellationScope {
+public:
+    explicit CancellationScope(const CancellationToken& token);
+    ~CancellationScope();
+    CancellationScope(const CancellationScope&) = delete;
+    CancellationScope& operator=(const CancellationScope&) = delete;
+
+private:
+    CancellationToken previous;
+};
+
+#endif // CANCELLATIONTOKEN_H
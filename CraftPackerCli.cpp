@@ -0,0 +1,432 @@
+#include "DependencyResolver.h"
+#include "DownloadScheduler.h"
+#include "JarStore.h"
+#include "MatrixResolver.h"
+#include "ModSearch.h"
+#include "PackLock.h"
+#include "Tracer.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QScopeGuard>
+#include <QSet>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QThreadPool>
+#include <vector>
+
+#if defined(Q_OS_WIN)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Headless front end: searches a mod list, resolves dependencies and fills a mods folder, then prints a
+// JSON report. Shares the engine with the GUI, so it can run packs in CI or benchmark without a display.
+
+static QTextStream& err() {
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// Peak resident set size of this process, or -1 where it can't be read.
+static qint64 peakMemoryKiB() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return -1;
+    return qint64(counters.PeakWorkingSetSize / 1024);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#if defined(Q_OS_MACOS)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+static QJsonArray notesToJson(const QList<DependencyNote>& notes) {
+    QJsonArray array;
+    for (const auto& n : notes) {
+        array.append(QJsonObject{{"projectId", n.projectId}, {"name", n.name}, {"requiredBy", n.requiredBy}});
+    }
+    return array;
+}
+
+static QJsonObject modEntry(const ModInfo& mod, const QString& match) {
+    return QJsonObject{{"query", mod.originalQuery}, {"name", mod.name}, {"projectId", mod.projectId},
+                       {"versionId", mod.versionId}, {"filename", mod.filename}, {"size", mod.size}, {"match", match}};
+}
+
+// Runs every queued download to completion on one scheduler. Returns the error for each iid that failed.
+static QHash<QString, QString> downloadAll(QCoreApplication& app, HttpEngine* http, JarStore* store, const QList<QPair<ModInfo, QString>>& queue, int maxConcurrent, int maxPerHost) {
+    QHash<QString, QString> errors;
+    if (queue.isEmpty()) return errors;
+    DownloadScheduler scheduler(http);
+    scheduler.setJarStore(store);
+    scheduler.setMaxConcurrent(maxConcurrent);
+    scheduler.setMaxPerHost(maxPerHost);
+    scheduler.setCancellationToken(CancellationToken::current());
+    QObject::connect(&scheduler, &DownloadScheduler::finished, [&errors](const QString& iid, const QString& error) {
+        if (!error.isEmpty()) errors.insert(iid, error);
+    });
+    QObject::connect(&scheduler, &DownloadScheduler::statsUpdated, [](double bytesPerSecond, int, int completedFiles, int totalFiles) {
+        err() << "Downloading " << completedFiles << "/" << totalFiles << " files at "
+              << QString::number(bytesPerSecond / (1024.0 * 1024.0), 'f', 1) << " MB/s" << Qt::endl;
+    });
+    // Queued, so a batch that finishes inside start() (everything cancelled or already in the store) still ends
+    // the loop instead of quitting before exec() is entered.
+    QObject::connect(&scheduler, &DownloadScheduler::allFinished, &app, &QCoreApplication::quit, Qt::QueuedConnection);
+    for (const auto& job : queue) {
+        QDir().mkpath(job.second);
+        scheduler.enqueue(job.first, job.second);
+    }
+    scheduler.start();
+    app.exec();
+    return errors;
+}
+
+static bool writeReport(const QJsonObject& report, const QString& path) {
+    QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (path.isEmpty()) {
+        QTextStream(stdout) << json;
+        return true;
+    }
+    QFile reportFile(path);
+    if (!reportFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        err() << "Cannot write report to " << reportFile.fileName() << Qt::endl;
+        return false;
+    }
+    reportFile.write(json);
+    return true;
+}
+
+static QStringList readModList(const QString& path) {
+    QFile file;
+    bool opened = false;
+    if (path == "-") {
+        opened = file.open(stdin, QIODevice::ReadOnly | QIODevice::Text);
+    } else {
+        file.setFileName(path);
+        opened = file.open(QIODevice::ReadOnly | QIODevice::Text);
+    }
+    QStringList names;
+    if (!opened) return names;
+    for (const QString& line : QString::fromUtf8(file.readAll()).split('\n')) {
+        QString name = line.trimmed();
+        if (!name.isEmpty() && !name.startsWith('#') && !names.contains(name)) names.append(name);
+    }
+    return names;
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication::setOrganizationName("CraftPacker");
+    QCoreApplication::setApplicationName("CraftPacker");
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Resolves a Minecraft mod list against Modrinth and downloads it with all required dependencies.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("modlist", "Text file with one mod name per line, or - to read from stdin. Not needed with --lock.");
+    QCommandLineOption versionOption({"m", "mc-version"}, "Minecraft version, e.g. 1.20.1.", "version");
+    QCommandLineOption loaderOption({"l", "loader"}, "Mod loader: fabric, forge, neoforge or quilt.", "loader", "fabric");
+    QCommandLineOption outputOption({"o", "output"}, "Directory to download mods into.", "dir", "mods");
+    QCommandLineOption reportOption({"r", "report"}, "Write the JSON report to this file instead of stdout.", "file");
+    QCommandLineOption jobsOption({"j", "jobs"}, "Concurrent searches.", "n", QString::number(QThread::idealThreadCount()));
+    QCommandLineOption downloadsOption("downloads", "Concurrent downloads.", "n", "8");
+    QCommandLineOption perHostOption("downloads-per-host", "Concurrent downloads per host.", "n", "6");
+    QCommandLineOption resolveOnlyOption("resolve-only", "Search and resolve dependencies without downloading anything.");
+    QCommandLineOption lockOption("lock", "Install exactly the files pinned in a lockfile or .mrpack, skipping search and resolution.", "file");
+    QCommandLineOption writeLockOption("write-lock", "Save the resolved pack as a lockfile, or as a Modrinth pack if the name ends in .mrpack.", "file");
+    QCommandLineOption loaderVersionOption("loader-version", "Loader version recorded in written lockfiles and .mrpack files.", "version");
+    QCommandLineOption apiBaseOption("api-base", "Modrinth API base URL, e.g. a local stand-in server for benchmarks.", "url", MODRINTH_API_BASE);
+    QCommandLineOption dataDirOption("data-dir", "Directory holding the metadata cache and name index. Use an empty directory for cold-cache runs.", "dir",
+                                     QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    QCommandLineOption targetOption({"t", "target"}, "Resolve for this loader and game version, e.g. fabric:1.20.1. Repeat to build a compatibility matrix; "
+                                    "each target downloads into its own subfolder of --output.", "loader:version");
+    QCommandLineOption traceOption("trace", "Record every request and write a Chrome trace-event file (open in chrome://tracing or Perfetto).", "file");
+    QCommandLineOption timeoutOption("timeout", "Abort a request when no data arrives for this many seconds.", "seconds", "30");
+    QCommandLineOption noStoreOption("no-store", "Download every file into --output instead of sharing jars with other packs through the store in --data-dir.");
+    QCommandLineOption gcStoreOption("gc-store", "After the run, delete stored jars that no pack folder uses any more.");
+    QCommandLineOption deadlineOption("deadline", "Give up on whatever is still running after this many seconds; the report lists what finished.", "seconds");
+    parser.addOptions({versionOption, loaderOption, outputOption, reportOption, jobsOption, downloadsOption, perHostOption, resolveOnlyOption,
+                       lockOption, writeLockOption, loaderVersionOption, apiBaseOption, dataDirOption, targetOption, traceOption,
+                       timeoutOption, deadlineOption, noStoreOption, gcStoreOption});
+    parser.process(app);
+    Tracer::instance().setEnabled(parser.isSet(traceOption));
+
+    std::optional<PackLock> lock;
+    if (parser.isSet(lockOption)) {
+        lock = PackLock::load(parser.value(lockOption));
+        if (!lock) {
+            err() << "Cannot read lockfile " << parser.value(lockOption) << Qt::endl;
+            return 1;
+        }
+    } else if (parser.positionalArguments().size() != 1 || (!parser.isSet(versionOption) && !parser.isSet(targetOption))) {
+        parser.showHelp(1);
+    }
+    QList<PackTarget> targets;
+    if (parser.isSet(versionOption)) targets.append({parser.value(loaderOption), parser.value(versionOption)});
+    for (const QString& value : parser.values(targetOption)) {
+        std::optional<PackTarget> target = MatrixResolver::parseTarget(value);
+        if (!target) {
+            err() << "Invalid target " << value << ", expected loader:version" << Qt::endl;
+            return 1;
+        }
+        if (!targets.contains(*target)) targets.append(*target);
+    }
+    bool matrix = parser.isSet(targetOption) && !lock;
+    if (matrix && parser.isSet(writeLockOption)) {
+        err() << "--write-lock pins a single target and cannot be combined with --target" << Qt::endl;
+        return 1;
+    }
+    QStringList names;
+    if (!lock) {
+        names = readModList(parser.positionalArguments().first());
+        if (names.isEmpty()) {
+            err() << "No mods to resolve in " << parser.positionalArguments().first() << Qt::endl;
+            return 1;
+        }
+    }
+    QString loader = lock && !parser.isSet(loaderOption) ? lock->loader : parser.value(loaderOption);
+    QString gameVersion = lock && !parser.isSet(versionOption) ? lock->gameVersion : parser.value(versionOption);
+    QString outputDir = QDir(parser.value(outputOption)).absolutePath();
+    QElapsedTimer elapsed;
+    elapsed.start();
+    // Everything below runs under one token, so the deadline bounds searches, resolution and downloads alike.
+    CancellationToken token = CancellationToken::create(parser.isSet(deadlineOption)
+        ? QDeadlineTimer(std::chrono::seconds(parser.value(deadlineOption).toInt())) : QDeadlineTimer(QDeadlineTimer::Forever));
+    CancellationScope scope(token);
+
+    RateLimiter rateLimiter(280);
+    HttpEngine http;
+    http.setTransferTimeout(qMax(1, parser.value(timeoutOption).toInt()) * 1000);
+    QString dataDir = parser.value(dataDirOption);
+    MetadataCache metadataCache(dataDir + "/cache");
+    ModrinthClient modrinth(&http, &metadataCache);
+    modrinth.setApiBase(parser.value(apiBaseOption));
+    http.setRateLimiter(QUrl(modrinth.apiBase()).host(), &rateLimiter);
+    QString indexPath = dataDir + "/name-index.bin";
+    NameIndex nameIndex;
+    nameIndex.load(indexPath);
+    JarStore jarStore(dataDir + "/jars");
+    jarStore.setEnabled(!parser.isSet(noStoreOption));
+    // http is built before the cache and client that take its address, so it would be destroyed after them;
+    // stopping it here, on every return, keeps network-thread callbacks from reaching them once they are gone.
+    auto stopHttp = qScopeGuard([&http]() { http.stop(); });
+
+    qint64 searchMs = 0, resolveMs = 0, downloadMs = 0;
+    auto stats = [&]() {
+        return QJsonObject{{"elapsedMs", elapsed.elapsed()}, {"searchMs", searchMs}, {"resolveMs", resolveMs}, {"downloadMs", downloadMs},
+                           {"requests", http.requestCount()}, {"bytesReceived", http.bytesReceived()},
+                           {"cacheHits", metadataCache.hits()}, {"cacheMisses", metadataCache.misses()},
+                           {"coalesced", modrinth.coalescedCount()}, {"peakMemoryKiB", peakMemoryKiB()},
+                           {"deadlineExceeded", token.isCancelled()},
+                           {"filesFromStore", jarStore.placedFiles()}, {"bytesFromStore", jarStore.placedBytes()}};
+    };
+    // Runs after everything is placed, so the files this run just linked count as references.
+    auto collectStore = [&]() {
+        if (!parser.isSet(gcStoreOption)) return;
+        qint64 freed = jarStore.collectGarbage();
+        err() << "Jar store: " << QString::number(freed / (1024.0 * 1024.0), 'f', 1) << " MB freed" << Qt::endl;
+    };
+
+    if (matrix) {
+        QStringList labels;
+        for (const auto& target : targets) labels.append(target.label());
+        err() << "Resolving " << names.size() << " mods for " << labels.join(", ") << "..." << Qt::endl;
+        MatrixResolver resolver(&modrinth, &nameIndex);
+        resolver.setMaxThreads(parser.value(jobsOption).toInt());
+        QList<TargetResolution> resolutions = resolver.resolve(names, targets);
+        nameIndex.save(indexPath);
+        resolveMs = elapsed.elapsed();
+
+        // The same file can be queued for several targets, so downloads are tracked as "<target>/<filename>".
+        QHash<QString, QString> downloadStatus;
+        QHash<QString, QString> downloadErrors;
+        if (!parser.isSet(resolveOnlyOption)) {
+            QList<QPair<ModInfo, QString>> queue;
+            for (const auto& r : resolutions) {
+                QString dir = outputDir + "/" + r.target.label();
+                for (ModInfo mod : r.resolution.downloadQueue) {
+                    mod.originalQuery = r.target.label() + "/" + mod.filename;
+                    mod.isDependency = false;
+                    JarStore::Method method = jarStore.provide(mod, dir);
+                    if (method != JarStore::Method::None) { downloadStatus.insert(mod.originalQuery, method == JarStore::Method::Present ? "skipped" : "from-store"); continue; }
+                    queue.append({mod, dir});
+                }
+            }
+            QElapsedTimer downloadTimer;
+            downloadTimer.start();
+            downloadErrors = downloadAll(app, &http, &jarStore, queue, parser.value(downloadsOption).toInt(), parser.value(perHostOption).toInt());
+            downloadMs = downloadTimer.elapsed();
+        }
+
+        bool complete = true;
+        QJsonArray targetReports;
+        for (const auto& r : resolutions) {
+            QJsonArray mods;
+            for (const auto& mod : r.resolution.downloadQueue) {
+                QJsonObject entry = modEntry(mod, mod.isDependency ? QString("dependency") : resolver.searchTags().value(mod.projectId));
+                QString key = r.target.label() + "/" + mod.filename;
+                if (parser.isSet(resolveOnlyOption)) {
+                    entry["download"] = "not-requested";
+                } else if (downloadErrors.contains(key)) {
+                    entry["download"] = "failed";
+                    entry["error"] = downloadErrors.value(key);
+                    complete = false;
+                } else {
+                    entry["download"] = downloadStatus.value(key, "downloaded");
+                }
+                mods.append(entry);
+            }
+            complete = complete && r.notFound.isEmpty() && r.resolution.unresolved.isEmpty() && r.resolution.incompatible.isEmpty();
+            targetReports.append(QJsonObject{
+                {"loader", r.target.loader},
+                {"gameVersion", r.target.gameVersion},
+                {"outputDir", outputDir + "/" + r.target.label()},
+                {"mods", mods},
+                {"notFound", QJsonArray::fromStringList(r.notFound)},
+                {"optional", notesToJson(r.resolution.optional)},
+                {"incompatible", notesToJson(r.resolution.incompatible)},
+                {"unresolved", notesToJson(r.resolution.unresolved)},
+            });
+        }
+        // One row per requested mod: the file each target would get, or null where it has no build.
+        QJsonArray table;
+        for (const QString& name : names) {
+            QJsonObject row{{"query", name}};
+            for (const auto& r : resolutions) {
+                auto it = r.found.constFind(name);
+                row[r.target.label()] = it == r.found.constEnd() ? QJsonValue() : QJsonValue(it->filename);
+            }
+            table.append(row);
+        }
+        collectStore();
+        if (!writeReport(QJsonObject{{"targets", targetReports}, {"matrix", table}, {"stats", stats()}}, parser.value(reportOption))) return 1;
+        if (parser.isSet(traceOption) && !Tracer::instance().exportChromeTrace(parser.value(traceOption))) {
+            err() << "Cannot write trace to " << parser.value(traceOption) << Qt::endl;
+            return 1;
+        }
+        return complete ? 0 : 2;
+    }
+
+    QHash<QString, QString> searchTags;
+    QJsonArray notFound;
+    ResolutionResult resolution;
+    if (lock) {
+        // Every file is pinned, so each one is tracked by its filename rather than by search query or project.
+        for (ModInfo mod : lock->mods) {
+            mod.originalQuery = mod.filename;
+            mod.isDependency = false;
+            resolution.downloadQueue.append(mod);
+        }
+    } else {
+        err() << "Searching for " << names.size() << " mods..." << Qt::endl;
+        std::vector<ModSearch::Result> searches(names.size());
+        QThreadPool searchPool;
+        searchPool.setMaxThreadCount(qMax(1, parser.value(jobsOption).toInt()));
+        for (int i = 0; i < names.size(); ++i) {
+            searchPool.start([&modrinth, &nameIndex, &searches, &names, i, loader, gameVersion, token]() {
+                CancellationScope scope(token);
+                searches[i] = ModSearch(&modrinth, &nameIndex).find(names.at(i), loader, gameVersion);
+            });
+        }
+        searchPool.waitForDone();
+        nameIndex.save(indexPath);
+        searchMs = elapsed.elapsed();
+
+        QList<ModInfo> roots;
+        QSet<QString> rootProjects;
+        for (int i = 0; i < names.size(); ++i) {
+            const ModSearch::Result& r = searches[i];
+            if (!r.mod) { notFound.append(names[i]); continue; }
+            if (rootProjects.contains(r.mod->projectId)) continue;
+            rootProjects.insert(r.mod->projectId);
+            searchTags.insert(r.mod->projectId, r.tag);
+            roots.append(*r.mod);
+        }
+
+        DependencyResolver resolver(&modrinth);
+        resolution = resolver.resolve(roots, loader, gameVersion, [](int level, int count) {
+            err() << "Resolving dependencies: level " << level << " (" << count << " mods)" << Qt::endl;
+        });
+        resolveMs = elapsed.elapsed() - searchMs;
+    }
+    if (parser.isSet(writeLockOption)) {
+        // A resolution cut short by the deadline is missing whatever was still in flight; pinning it would
+        // produce a pack that looks complete and isn't.
+        if (token.isCancelled()) {
+            err() << "Deadline passed before resolution finished; not writing " << parser.value(writeLockOption) << Qt::endl;
+            return 1;
+        }
+        PackLock written;
+        written.name = lock ? lock->name : QFileInfo(parser.positionalArguments().first()).completeBaseName();
+        written.gameVersion = gameVersion;
+        written.loader = loader;
+        written.loaderVersion = parser.isSet(loaderVersionOption) || !lock ? parser.value(loaderVersionOption) : lock->loaderVersion;
+        written.mods = resolution.downloadQueue;
+        if (!written.save(parser.value(writeLockOption))) {
+            err() << "Cannot write lockfile " << parser.value(writeLockOption) << Qt::endl;
+            return 1;
+        }
+    }
+
+    QHash<QString, QString> downloadStatus;
+    QHash<QString, QString> downloadErrors;
+    if (!parser.isSet(resolveOnlyOption)) {
+        QDir().mkpath(outputDir);
+        QList<QPair<ModInfo, QString>> queue;
+        for (const auto& mod : resolution.downloadQueue) {
+            JarStore::Method method = jarStore.provide(mod, outputDir);
+            if (method != JarStore::Method::None) { downloadStatus.insert(mod.filename, method == JarStore::Method::Present ? "skipped" : "from-store"); continue; }
+            queue.append({mod, outputDir});
+        }
+        QElapsedTimer downloadTimer;
+        downloadTimer.start();
+        downloadErrors = downloadAll(app, &http, &jarStore, queue, parser.value(downloadsOption).toInt(), parser.value(perHostOption).toInt());
+        downloadMs = downloadTimer.elapsed();
+    }
+
+    bool complete = notFound.isEmpty() && resolution.unresolved.isEmpty() && resolution.incompatible.isEmpty();
+    QJsonArray mods;
+    for (const auto& mod : resolution.downloadQueue) {
+        QString iid = mod.isDependency ? mod.projectId : mod.originalQuery;
+        QJsonObject entry = modEntry(mod, lock ? QString("locked") : mod.isDependency ? QString("dependency") : searchTags.value(mod.projectId));
+        if (parser.isSet(resolveOnlyOption)) {
+            entry["download"] = "not-requested";
+        } else if (downloadErrors.contains(iid)) {
+            entry["download"] = "failed";
+            entry["error"] = downloadErrors.value(iid);
+            complete = false;
+        } else {
+            entry["download"] = downloadStatus.value(mod.filename, "downloaded");
+        }
+        mods.append(entry);
+    }
+    QJsonObject report{
+        {"loader", loader},
+        {"gameVersion", gameVersion},
+        {"outputDir", outputDir},
+        {"mods", mods},
+        {"notFound", notFound},
+        {"optional", notesToJson(resolution.optional)},
+        {"incompatible", notesToJson(resolution.incompatible)},
+        {"unresolved", notesToJson(resolution.unresolved)},
+        {"stats", stats()},
+    };
+    collectStore();
+    if (!writeReport(report, parser.value(reportOption))) return 1;
+    if (parser.isSet(traceOption) && !Tracer::instance().exportChromeTrace(parser.value(traceOption))) {
+        err() << "Cannot write trace to " << parser.value(traceOption) << Qt::endl;
+        return 1;
+    }
+    return complete ? 0 : 2;
+}
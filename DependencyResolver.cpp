@@ -0,0 +1,84 @@
+#include "DependencyResolver.h"
+
+#include <QSet>
+#include <algorithm>
+
+DependencyResolver::DependencyResolver(ModrinthClient* client) : client(client) {}
+
+ResolutionResult DependencyResolver::resolve(const QList<ModInfo>& roots, const QString& loader, const QString& gameVersion, LevelCallback onLevel) {
+    ResolutionResult result;
+    QSet<QString> seen;
+    QHash<QString, QString> names;
+    QList<QList<ModInfo>> levels;
+    QList<DependencyNote> optionalEdges, incompatibleEdges;
+    QList<ModInfo> frontier;
+    for (const ModInfo& root : roots) {
+        if (seen.contains(root.projectId)) continue;
+        seen.insert(root.projectId);
+        frontier.append(root);
+    }
+    while (!frontier.isEmpty()) {
+        if (CancellationToken::current().isCancelled()) break;
+        std::sort(frontier.begin(), frontier.end(), [](const ModInfo& a, const ModInfo& b) { return a.projectId < b.projectId; });
+        levels.append(frontier);
+        if (onLevel) onLevel(levels.size(), frontier.size());
+        QList<ModRef> pending;
+        QHash<QString, QString> requiredBy;
+        for (const ModInfo& mod : frontier) {
+            names.insert(mod.projectId, mod.name);
+            for (const Dependency& d : mod.dependencies) {
+                QString key = d.projectId.isEmpty() ? d.versionId : d.projectId;
+                if (key.isEmpty()) continue;
+                if (d.kind == Dependency::Kind::Required) {
+                    if (seen.contains(key) || requiredBy.contains(key)) continue;
+                    requiredBy.insert(key, mod.name);
+                    pending.append({d.projectId, d.versionId});
+                } else if (d.kind == Dependency::Kind::Optional && !d.projectId.isEmpty()) {
+                    optionalEdges.append({d.projectId, QString(), mod.name});
+                } else if (d.kind == Dependency::Kind::Incompatible && !d.projectId.isEmpty()) {
+                    incompatibleEdges.append({d.projectId, QString(), mod.name});
+                }
+            }
+        }
+        frontier.clear();
+        if (pending.isEmpty()) break;
+        QHash<QString, ModInfo> fetched = client->getModInfos(pending, loader, gameVersion);
+        for (const ModRef& ref : pending) {
+            QString key = ref.projectId.isEmpty() ? ref.versionId : ref.projectId;
+            if (!fetched.contains(key)) {
+                result.unresolved.append({key, QString(), requiredBy.value(key)});
+                continue;
+            }
+            ModInfo dep = fetched.value(key);
+            if (seen.contains(dep.projectId)) continue;
+            seen.insert(dep.projectId);
+            dep.isDependency = true;
+            frontier.append(dep);
+        }
+    }
+    for (auto it = levels.crbegin(); it != levels.crend(); ++it) result.downloadQueue.append(*it);
+    result.levels = levels.size();
+
+    // Optional deps are only worth mentioning if nothing else pulled them in; incompatibilities only
+    // matter when both sides ended up in the closure.
+    QSet<QString> reported;
+    for (const DependencyNote& edge : optionalEdges) {
+        if (seen.contains(edge.projectId) || reported.contains(edge.projectId)) continue;
+        reported.insert(edge.projectId);
+        result.optional.append(edge);
+    }
+    for (const DependencyNote& edge : incompatibleEdges) {
+        if (seen.contains(edge.projectId)) result.incompatible.append(edge);
+    }
+    QStringList unnamed;
+    for (const auto* notes : {&result.optional, &result.unresolved}) {
+        for (const DependencyNote& note : *notes) {
+            if (!note.projectId.isEmpty() && !names.contains(note.projectId)) unnamed.append(note.projectId);
+        }
+    }
+    if (!unnamed.isEmpty()) names.insert(client->getProjectTitles(unnamed));
+    for (auto* notes : {&result.optional, &result.incompatible, &result.unresolved}) {
+        for (DependencyNote& note : *notes) note.name = names.value(note.projectId, note.projectId);
+    }
+    return result;
+}
@@ -0,0 +1,36 @@
+#ifndef DEPENDENCYRESOLVER_H
+#define DEPENDENCYRESOLVER_H
+
+#include <functional>
+#include "ModrinthClient.h"
+
+struct DependencyNote {
+    QString projectId;
+    QString name;
+    QString requiredBy;
+};
+
+struct ResolutionResult {
+    // Deepest dependencies first; each level is ordered by project id so the output is stable between runs.
+    QList<ModInfo> downloadQueue;
+    QList<DependencyNote> optional;
+    QList<DependencyNote> incompatible;
+    QList<DependencyNote> unresolved;
+    int levels = 0;
+};
+
+// Walks the dependency graph one level at a time: the whole frontier is resolved in a single batched,
+// concurrent pass, and every project is visited at most once per run, which also breaks cycles. Stops
+// between levels once the current CancellationToken is cancelled.
+class DependencyResolver {
+public:
+    using LevelCallback = std::function<void(int level, int count)>;
+
+    explicit DependencyResolver(ModrinthClient* client);
+    ResolutionResult resolve(const QList<ModInfo>& roots, const QString& loader, const QString& gameVersion, LevelCallback onLevel = nullptr);
+
+private:
+    ModrinthClient* client;
+};
+
+#endif // DEPENDENCYRESOLVER_H
@@ -0,0 +1,234 @@
+#include "DownloadScheduler.h"
+#include "FileHash.h"
+#include "JarStore.h"
+#include "Tracer.h"
+
+#include <QFile>
+#include <QThreadPool>
+#include <algorithm>
+#include <utility>
+
+const int STATS_INTERVAL_MS = 500;
+
+struct DownloadState {
+    DownloadState(const QString& path, QCryptographicHash::Algorithm algorithm) : file(path), hash(algorithm) {}
+    QFile file;
+    QCryptographicHash hash;
+    qint64 offset = 0;
+    bool started = false;
+};
+
+DownloadWorker::DownloadWorker(ModInfo mod, QString dir, HttpEngine* http, std::shared_ptr<TransferProgress> progress, JarStore* store) : modInfo(mod), downloadDir(dir), http(http), transfer(progress), store(store) {}
+DownloadWorker::~DownloadWorker() = default;
+
+bool DownloadWorker::isDownloaded(const ModInfo& mod, const QString& dir) {
+    return fileMatches(dir + "/" + mod.filename, mod.size, mod.sha1, mod.sha512);
+}
+
+QString DownloadWorker::finalize(DownloadState& state, const QString& partPath, const QString& finalPath, const QString& expectedHash) {
+    state.file.close();
+    // Covers the rename and the store adopting the jar, which copies it when a hard link isn't possible.
+    TraceScope scope("disk", "finalize " + modInfo.filename, state.file.size());
+    if (!expectedHash.isEmpty() && QString::fromLatin1(state.hash.result().toHex()) != expectedHash) {
+        QFile::remove(partPath);
+        return "Hash Mismatch";
+    }
+    QFile::remove(finalPath);
+    if (!QFile::rename(partPath, finalPath)) return "File Error";
+    if (store) store->adopt(modInfo, finalPath);
+    return QString();
+}
+
+// finalize() may copy the whole jar into the store when it can't be linked, so it runs in the pool and the
+// result is reported back on this thread.
+void DownloadWorker::finishInPool(std::shared_ptr<DownloadState> state) {
+    QThreadPool::globalInstance()->start([this, state]() {
+        QString finalPath = downloadDir + "/" + modInfo.filename;
+        QString error = finalize(*state, finalPath + ".part", finalPath, modInfo.sha512.isEmpty() ? modInfo.sha1 : modInfo.sha512);
+        QMetaObject::invokeMethod(this, [this, error]() {
+            emit finished(modInfo.isDependency ? modInfo.projectId : modInfo.originalQuery, error);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void DownloadWorker::process() {
+    QString iid = modInfo.isDependency ? modInfo.projectId : modInfo.originalQuery;
+    if (CancellationToken::current().isCancelled()) { emit finished(iid, "Cancelled"); return; }
+    bool useSha512 = !modInfo.sha512.isEmpty();
+    QString finalPath = downloadDir + "/" + modInfo.filename;
+    auto state = std::make_shared<DownloadState>(finalPath + ".part", useSha512 ? QCryptographicHash::Sha512 : QCryptographicHash::Sha1);
+    // Placing from the store can mean copying a whole jar, and resuming folds the bytes already on disk into the
+    // hash so the finished file is never re-read. Both happen in the pool and the transfer starts back on this thread.
+    QThreadPool::globalInstance()->start([this, iid, state, token = CancellationToken::current()]() {
+        // Another job in this batch may have stored the same file by now, e.g. one jar shared by several targets.
+        bool placed = store && store->place(modInfo, downloadDir) != JarStore::Method::None;
+        if (placed) transfer->received.storeRelaxed(modInfo.size);
+        bool opened = !placed && openPart(*state);
+        QMetaObject::invokeMethod(this, [this, iid, state, token, placed, opened]() {
+            if (placed) { emit finished(iid, QString()); return; }
+            CancellationScope scope(token);
+            startTransfer(state, opened);
+        }, Qt::QueuedConnection);
+    });
+}
+
+// Runs in the pool.
+bool DownloadWorker::openPart(DownloadState& state) {
+    if (!state.file.open(QIODevice::ReadWrite)) return false;
+    if (modInfo.size > 0 && state.file.size() > modInfo.size) state.file.resize(0);
+    if (!state.hash.addData(&state.file)) { state.file.resize(0); state.hash.reset(); }
+    state.offset = state.file.size();
+    state.file.seek(state.offset);
+    return true;
+}
+
+void DownloadWorker::startTransfer(std::shared_ptr<DownloadState> state, bool opened) {
+    QString iid = modInfo.isDependency ? modInfo.projectId : modInfo.originalQuery;
+    if (!opened) { emit finished(iid, "File Error"); return; }
+    if (CancellationToken::current().isCancelled()) { state->file.close(); emit finished(iid, "Cancelled"); return; }
+    transfer->received.storeRelaxed(state->offset);
+    if (modInfo.size > 0 && state->offset == modInfo.size) { finishInPool(state); return; }
+    QNetworkRequest request(QUrl(modInfo.downloadUrl));
+    if (state->offset > 0) request.setRawHeader("Range", "bytes=" + QByteArray::number(state->offset) + "-");
+    http->download(request,
+        [state](const QByteArray& chunk, int status) {
+            if (!state->started) {
+                state->started = true;
+                if (status == 200 && state->offset > 0) {
+                    // The server ignored the Range header and is sending the whole file.
+                    state->file.resize(0);
+                    state->file.seek(0);
+                    state->hash.reset();
+                    state->offset = 0;
+                }
+            }
+            if (status >= 300) return true;
+            {
+                TraceScope scope("disk", "write .part", chunk.size());
+                if (state->file.write(chunk) != chunk.size()) return false;
+            }
+            state->hash.addData(chunk);
+            return true;
+        },
+        [state, transfer = transfer](qint64 r, qint64 t) {
+            transfer->received.storeRelaxed(state->offset + r);
+            transfer->total.storeRelaxed(t > 0 ? state->offset + t : -1);
+        },
+        this,
+        [this, iid, state](const HttpResponse& reply) {
+            if (reply.ok() || reply.statusCode == 416) { finishInPool(state); return; }
+            state->file.close();
+            emit finished(iid, reply.errorString);
+        });
+}
+
+DownloadScheduler::DownloadScheduler(HttpEngine* http, QObject* parent) : QObject(parent), http(http) {
+    statsTimer.setInterval(STATS_INTERVAL_MS);
+    connect(&statsTimer, &QTimer::timeout, this, &DownloadScheduler::sampleThroughput);
+}
+
+void DownloadScheduler::enqueue(const ModInfo& mod, const QString& dir) {
+    if (isIdle()) {
+        jobs.clear();
+        completed = 0;
+        totalBytes = lastSampleBytes = 0;
+        bytesPerSecond = 0;
+        if (token.isCancelled()) token = CancellationToken::create();
+    }
+    Job job;
+    job.mod = mod;
+    job.dir = dir;
+    job.iid = mod.isDependency ? mod.projectId : mod.originalQuery;
+    job.host = QUrl(mod.downloadUrl).host();
+    job.progress = std::make_shared<TransferProgress>();
+    jobs.append(job);
+    pending.append(jobs.size() - 1);
+    totalBytes += mod.size;
+}
+
+void DownloadScheduler::start() {
+    std::stable_sort(pending.begin(), pending.end(), [this](int a, int b) { return jobs[a].mod.size > jobs[b].mod.size; });
+    if (!statsTimer.isActive()) statsTimer.start();
+    if (isIdle()) { statsTimer.stop(); emit allFinished(); return; }
+    schedule();
+}
+
+void DownloadScheduler::schedule() {
+    if (token.isCancelled()) { cancelPending(); return; }
+    for (int i = 0; i < pending.size() && active < maxConcurrent;) {
+        if (activePerHost.value(jobs[pending[i]].host) >= maxPerHost) { ++i; continue; }
+        startJob(pending.takeAt(i));
+    }
+}
+
+void DownloadScheduler::startJob(int index) {
+    Job& job = jobs[index];
+    active++;
+    activePerHost[job.host]++;
+    DownloadWorker* worker = new DownloadWorker(job.mod, job.dir, http, job.progress, store);
+    connect(worker, &DownloadWorker::finished, this, [this, index](const QString&, const QString& error) { onJobFinished(index, error); });
+    connect(worker, &DownloadWorker::finished, worker, &QObject::deleteLater);
+    CancellationScope scope(token);
+    worker->process();
+}
+
+void DownloadScheduler::onJobFinished(int index, const QString& error) {
+    Job& job = jobs[index];
+    active--;
+    activePerHost[job.host]--;
+    if (!error.isEmpty() && error != "File Error" && !token.isCancelled() && job.attempts < maxRetries) {
+        int delay = 1000 << job.attempts++;
+        job.progress->received.storeRelaxed(0);
+        QTimer::singleShot(delay, this, [this, index]() { pending.prepend(index); schedule(); });
+    } else {
+        completed++;
+        emit finished(job.iid, error);
+    }
+    if (isIdle()) {
+        statsTimer.stop();
+        sampleThroughput();
+        emit allFinished();
+    } else {
+        schedule();
+    }
+}
+
+void DownloadScheduler::cancel() {
+    token.cancel();
+    cancelPending();
+}
+
+void DownloadScheduler::cancelPending() {
+    if (pending.isEmpty()) return;
+    const QList<int> cancelled = std::exchange(pending, {});
+    for (int index : cancelled) {
+        completed++;
+        emit finished(jobs[index].iid, "Cancelled");
+    }
+    if (isIdle()) {
+        statsTimer.stop();
+        sampleThroughput();
+        emit allFinished();
+    }
+}
+
+QList<DownloadScheduler::Progress> DownloadScheduler::takeProgress() {
+    QList<Progress> updates;
+    for (Job& job : jobs) {
+        qint64 received = job.progress->received.loadRelaxed();
+        if (received == job.reported) continue;
+        job.reported = received;
+        updates.append({job.iid, received, job.progress->total.loadRelaxed()});
+    }
+    return updates;
+}
+
+void DownloadScheduler::sampleThroughput() {
+    qint64 receivedBytes = 0;
+    for (const Job& job : jobs) receivedBytes += job.progress->received.loadRelaxed();
+    double instant = qMax<qint64>(0, receivedBytes - lastSampleBytes) * 1000.0 / STATS_INTERVAL_MS;
+    lastSampleBytes = receivedBytes;
+    bytesPerSecond = bytesPerSecond <= 0 ? instant : 0.7 * bytesPerSecond + 0.3 * instant;
+    int eta = bytesPerSecond > 0 ? int(qMax<qint64>(0, totalBytes - receivedBytes) / bytesPerSecond) : -1;
+    emit statsUpdated(bytesPerSecond, eta, completed, jobs.size());
+}
@@ -0,0 +1,115 @@
+#ifndef DOWNLOADSCHEDULER_H
+#define DOWNLOADSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <memory>
+#include "ModrinthClient.h"
+
+struct DownloadState;
+class JarStore;
+
+// Written by the network thread as bytes arrive and read by whoever wants to display them, so progress
+// never costs a signal per chunk.
+struct TransferProgress {
+    QAtomicInteger<qint64> received{0};
+    QAtomicInteger<qint64> total{-1};
+};
+
+// Downloads into <filename>.part, resuming with a Range request if a partial file is already there.
+// The file's SHA-512 (or SHA-1) is computed as bytes arrive and only a verified file is renamed into place.
+// With a JarStore, a file the store already holds is placed from it instead, and every finished download
+// is added to it.
+class DownloadWorker : public QObject {
+    Q_OBJECT
+public:
+    DownloadWorker(ModInfo mod, QString dir, HttpEngine* http, std::shared_ptr<TransferProgress> progress, JarStore* store = nullptr);
+    ~DownloadWorker();
+    // True if dir already holds this exact file, compared by size and hash rather than by name.
+    static bool isDownloaded(const ModInfo& mod, const QString& dir);
+public slots:
+    void process();
+signals:
+    void finished(const QString& iid, const QString& error);
+private:
+    bool openPart(DownloadState& state);
+    void startTransfer(std::shared_ptr<DownloadState> state, bool opened);
+    QString finalize(DownloadState& state, const QString& partPath, const QString& finalPath, const QString& expectedHash);
+    void finishInPool(std::shared_ptr<DownloadState> state);
+
+    ModInfo modInfo;
+    QString downloadDir;
+    HttpEngine* http;
+    std::shared_ptr<TransferProgress> transfer;
+    JarStore* store;
+};
+
+// Runs downloads on the shared HttpEngine with a global and a per-host concurrency cap. Largest files
+// start first so the batch doesn't end waiting on one big jar; failed transfers are retried with
+// exponential backoff. Lives on the GUI thread.
+class DownloadScheduler : public QObject {
+    Q_OBJECT
+public:
+    explicit DownloadScheduler(HttpEngine* http, QObject* parent = nullptr);
+
+    void setMaxConcurrent(int n) { maxConcurrent = qMax(1, n); }
+    void setMaxPerHost(int n) { maxPerHost = qMax(1, n); }
+    void setMaxRetries(int n) { maxRetries = qMax(0, n); }
+    void setJarStore(JarStore* s) { store = s; }
+
+    // Downloads started from now on run under this token; cancelling it ends the batch.
+    void setCancellationToken(const CancellationToken& t) { token = t; }
+    // Aborts transfers in flight and reports every job that hasn't finished as "Cancelled".
+    void cancel();
+
+    void enqueue(const ModInfo& mod, const QString& dir);
+    void start();
+    bool isIdle() const { return completed == jobs.size(); }
+
+    struct Progress {
+        QString iid;
+        qint64 received;
+        qint64 total;
+    };
+    // Transfers whose byte count moved since the last call. Meant to be polled from a UI timer.
+    QList<Progress> takeProgress();
+
+signals:
+    void finished(const QString& iid, const QString& error);
+    void statsUpdated(double bytesPerSecond, int etaSeconds, int completedFiles, int totalFiles);
+    void allFinished();
+
+private:
+    struct Job {
+        ModInfo mod;
+        QString dir;
+        QString iid;
+        QString host;
+        int attempts = 0;
+        std::shared_ptr<TransferProgress> progress;
+        qint64 reported = -1;
+    };
+    void schedule();
+    void startJob(int index);
+    void onJobFinished(int index, const QString& error);
+    void sampleThroughput();
+    void cancelPending();
+
+    HttpEngine* http;
+    JarStore* store = nullptr;
+    int maxConcurrent = 8;
+    int maxPerHost = 6;
+    int maxRetries = 3;
+    QList<Job> jobs;
+    QList<int> pending;
+    QHash<QString, int> activePerHost;
+    int active = 0;
+    int completed = 0;
+    qint64 totalBytes = 0;
+    qint64 lastSampleBytes = 0;
+    double bytesPerSecond = 0;
+    QTimer statsTimer;
+    CancellationToken token = CancellationToken::create();
+};
+
+#endif // DOWNLOADSCHEDULER_H
@@ -0,0 +1,27 @@
+#include "FileHash.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+QString hashFile(const QString& path, QCryptographicHash::Algorithm algorithm) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return QString();
+    QCryptographicHash hash(algorithm);
+    qint64 size = file.size();
+    if (uchar* data = size > 0 ? file.map(0, size) : nullptr) {
+        hash.addData(QByteArrayView(reinterpret_cast<const char*>(data), size));
+        file.unmap(data);
+    } else if (!hash.addData(&file)) {
+        return QString();
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+bool fileMatches(const QString& path, qint64 size, const QString& sha1, const QString& sha512) {
+    QFileInfo info(path);
+    if (!info.exists()) return false;
+    if (size > 0 && info.size() != size) return false;
+    if (!sha1.isEmpty()) return hashFile(path, QCryptographicHash::Sha1) == sha1;
+    if (!sha512.isEmpty()) return hashFile(path, QCryptographicHash::Sha512) == sha512;
+    return true;
+}
@@ -0,0 +1,14 @@
+#ifndef FILEHASH_H
+#define FILEHASH_H
+
+#include <QCryptographicHash>
+#include <QString>
+
+// Hashes a whole file through a memory mapping, falling back to buffered reads when the file
+// can't be mapped. Returns a lowercase hex digest, or an empty string if the file can't be opened.
+QString hashFile(const QString& path, QCryptographicHash::Algorithm algorithm);
+// True if path exists with this size and hash. A size of 0 or less isn't checked, nor are empty hashes; with
+// both hashes given only SHA-1 is computed, as the cheaper of the two.
+bool fileMatches(const QString& path, qint64 size, const QString& sha1, const QString& sha512);
+
+#endif // FILEHASH_H
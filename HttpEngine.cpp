@@ -0,0 +1,367 @@
+#include "HttpEngine.h"
+#include "Tracer.h"
+
+#include <QNetworkAccessManager>
+#include <QPointer>
+#include <QSet>
+#include <QPromise>
+#include <QTimer>
+
+const QByteArray USER_AGENT = "helloworldx64/CraftPacker/1.0 (github.com/helloworldx64/CraftPacker)";
+
+QByteArray HttpResponse::header(const QByteArray& name) const {
+    for (const auto& pair : headers) {
+        if (pair.first.compare(name, Qt::CaseInsensitive) == 0) return pair.second;
+    }
+    return QByteArray();
+}
+
+const int MAX_RATE_LIMIT_RETRIES = 5;
+
+struct PendingRequest {
+    QNetworkRequest request;
+    QByteArray body;
+    bool post = false;
+    HttpEngine::DataCallback onData;
+    HttpEngine::ProgressCallback onProgress;
+    HttpEngine::Callback onFinished;
+    int attempts = 0;
+    CancellationToken token;
+    // Subscription that purges this request from its host queue when the token is cancelled.
+    int queuedSubscription = 0;
+    // Tracer timestamps: handed to the engine, picked up by the network thread.
+    qint64 enqueuedUs = 0;
+    qint64 arrivedUs = 0;
+};
+
+// Filled in while a reply is in flight so its trace event can split waiting from transferring.
+struct ReplyTrace {
+    qint64 sentUs = 0;
+    qint64 firstByteUs = -1;
+    qint64 bytes = 0;
+};
+
+// Requests to a rate-limited host wait in per-priority queues until the host's token bucket has a
+// token; a single-shot timer wakes the queue up again instead of sleeping a thread.
+struct HostQueue {
+    RateLimiter* limiter = nullptr;
+    QList<PendingRequest> byPriority[3];
+    QTimer* timer = nullptr;
+};
+
+class HttpDispatcher : public QObject {
+public:
+    explicit HttpDispatcher(HttpEngine* engine) : engine(engine), manager(new QNetworkAccessManager(this)) {}
+    ~HttpDispatcher() { qDeleteAll(hosts); }
+    void enqueue(PendingRequest pending);
+    void setRateLimiter(const QString& host, RateLimiter* limiter);
+    void callAt(int id, QDeadlineTimer deadline, std::function<void()> callback);
+    void cancelCall(int id);
+private:
+    static void finishCancelled(const PendingRequest& pending);
+    void watchWhileQueued(PendingRequest& pending);
+    void purgeCancelled();
+    static int priorityIndex(const QNetworkRequest& request);
+    void pump(HostQueue* queue);
+    void send(PendingRequest pending, HostQueue* queue);
+    bool retryIfRateLimited(const HttpResponse& response, PendingRequest& pending, HostQueue* queue);
+    static void record(const PendingRequest& pending, const ReplyTrace& trace, int statusCode);
+
+    HttpEngine* engine;
+    QNetworkAccessManager* manager;
+    QHash<QString, HostQueue*> hosts;
+    // Replies that have not finished yet; a cancel request for anything else is stale.
+    QSet<QNetworkReply*> liveReplies;
+    // Timers scheduled by callAt() that have not fired yet.
+    QHash<int, QTimer*> calls;
+};
+
+int HttpDispatcher::priorityIndex(const QNetworkRequest& request) {
+    switch (request.priority()) {
+    case QNetworkRequest::HighPriority: return 0;
+    case QNetworkRequest::LowPriority: return 2;
+    default: return 1;
+    }
+}
+
+void HttpDispatcher::setRateLimiter(const QString& host, RateLimiter* limiter) {
+    HostQueue* queue = hosts.value(host);
+    if (!queue) {
+        queue = new HostQueue;
+        queue->timer = new QTimer(this);
+        queue->timer->setSingleShot(true);
+        connect(queue->timer, &QTimer::timeout, this, [this, queue]() { pump(queue); });
+        hosts.insert(host, queue);
+    }
+    queue->limiter = limiter;
+}
+
+void HttpDispatcher::callAt(int id, QDeadlineTimer deadline, std::function<void()> callback) {
+    auto* timer = new QTimer(this);
+    timer->setSingleShot(true);
+    connect(timer, &QTimer::timeout, this, [this, id, timer, callback]() {
+        calls.remove(id);
+        timer->deleteLater();
+        callback();
+    });
+    calls.insert(id, timer);
+    timer->start(std::chrono::milliseconds(deadline.remainingTime()));
+}
+
+void HttpDispatcher::cancelCall(int id) {
+    // Deleting the timer destroys the connected lambda, and with it the callback's captures.
+    delete calls.take(id);
+}
+
+void HttpDispatcher::finishCancelled(const PendingRequest& pending) {
+    HttpResponse response;
+    response.error = QNetworkReply::OperationCanceledError;
+    response.errorString = "Cancelled";
+    pending.onFinished(response);
+}
+
+void HttpDispatcher::watchWhileQueued(PendingRequest& pending) {
+    if (!pending.token.canBeCancelled()) return;
+    pending.queuedSubscription = pending.token.subscribe([this]() {
+        QMetaObject::invokeMethod(this, [this]() { purgeCancelled(); }, Qt::QueuedConnection);
+    });
+    QDeadlineTimer deadline = pending.token.deadline();
+    if (!deadline.isForever()) QTimer::singleShot(std::chrono::milliseconds(deadline.remainingTime()), this, [this]() { purgeCancelled(); });
+}
+
+void HttpDispatcher::purgeCancelled() {
+    for (HostQueue* queue : std::as_const(hosts)) {
+        for (auto& list : queue->byPriority) {
+            for (int i = 0; i < list.size();) {
+                if (!list[i].token.isCancelled()) { ++i; continue; }
+                PendingRequest pending = list.takeAt(i);
+                pending.token.unsubscribe(pending.queuedSubscription);
+                finishCancelled(pending);
+            }
+        }
+    }
+}
+
+void HttpDispatcher::enqueue(PendingRequest pending) {
+    pending.arrivedUs = Tracer::instance().nowUs();
+    if (pending.token.isCancelled()) { finishCancelled(pending); return; }
+    HostQueue* queue = hosts.value(pending.request.url().host());
+    if (!queue || !queue->limiter) { send(pending, nullptr); return; }
+    watchWhileQueued(pending);
+    queue->byPriority[priorityIndex(pending.request)].append(pending);
+    pump(queue);
+}
+
+void HttpDispatcher::pump(HostQueue* queue) {
+    for (;;) {
+        int p = 0;
+        while (p < 3 && queue->byPriority[p].isEmpty()) ++p;
+        if (p == 3) return;
+        // Cancelled requests leave the queue without spending a token.
+        bool cancelled = queue->byPriority[p].first().token.isCancelled();
+        if (!cancelled) {
+            auto wait = queue->limiter->tryAcquire();
+            if (wait.count() > 0) { queue->timer->start(wait); return; }
+        }
+        PendingRequest pending = queue->byPriority[p].takeFirst();
+        pending.token.unsubscribe(pending.queuedSubscription);
+        if (cancelled) finishCancelled(pending);
+        else send(pending, queue);
+    }
+}
+
+bool HttpDispatcher::retryIfRateLimited(const HttpResponse& response, PendingRequest& pending, HostQueue* queue) {
+    if (!queue) return false;
+    bool limitOk = false, remainingOk = false, resetOk = false;
+    int limit = response.header("X-Ratelimit-Limit").toInt(&limitOk);
+    int remaining = response.header("X-Ratelimit-Remaining").toInt(&remainingOk);
+    int reset = response.header("X-Ratelimit-Reset").toInt(&resetOk);
+    queue->limiter->updateFromHeaders(limitOk ? limit : -1, remainingOk ? remaining : -1, resetOk ? reset : -1);
+    if (response.statusCode != 429) {
+        if (response.ok()) queue->limiter->recordSuccess();
+        return false;
+    }
+    if (pending.attempts >= MAX_RATE_LIMIT_RETRIES || pending.token.isCancelled()) return false;
+    bool retryAfterOk = false;
+    int retryAfter = response.header("Retry-After").toInt(&retryAfterOk);
+    if (!retryAfterOk) retryAfter = resetOk ? reset : 0;
+    queue->limiter->backoff(std::chrono::seconds(retryAfter));
+    pending.attempts++;
+    pending.enqueuedUs = pending.arrivedUs = Tracer::instance().nowUs();
+    watchWhileQueued(pending);
+    queue->byPriority[priorityIndex(pending.request)].prepend(pending);
+    pump(queue);
+    return true;
+}
+
+void HttpDispatcher::record(const PendingRequest& pending, const ReplyTrace& trace, int statusCode) {
+    Tracer& tracer = Tracer::instance();
+    if (!tracer.isEnabled()) return;
+    qint64 now = tracer.nowUs();
+    qint64 firstByte = trace.firstByteUs >= 0 ? trace.firstByteUs : now;
+    QUrl url = pending.request.url();
+    TraceEvent event;
+    event.category = "http";
+    event.name = QString("%1 %2%3 (%4)").arg(QString(pending.post ? "POST" : "GET"), url.host(), url.path()).arg(statusCode);
+    event.startUs = pending.enqueuedUs;
+    event.durationUs = now - pending.enqueuedUs;
+    event.bytes = trace.bytes;
+    event.queueUs = pending.arrivedUs - pending.enqueuedUs;
+    event.rateLimitUs = trace.sentUs - pending.arrivedUs;
+    event.ttfbUs = firstByte - trace.sentUs;
+    event.transferUs = now - firstByte;
+    tracer.record(std::move(event));
+}
+
+void HttpDispatcher::send(PendingRequest pending, HostQueue* queue) {
+    QNetworkReply* reply = pending.post ? manager->post(pending.request, pending.body) : manager->get(pending.request);
+    engine->requests.fetchAndAddRelaxed(1);
+    liveReplies.insert(reply);
+    // Cancelling aborts the reply from the network thread; the finished handler then reports it like any failure.
+    int cancelSubscription = pending.token.subscribe([this, reply]() {
+        QMetaObject::invokeMethod(this, [this, reply]() { if (liveReplies.contains(reply)) reply->abort(); }, Qt::QueuedConnection);
+    });
+    QDeadlineTimer deadline = pending.token.deadline();
+    if (!deadline.isForever()) QTimer::singleShot(std::chrono::milliseconds(deadline.remainingTime()), reply, &QNetworkReply::abort);
+    auto trace = std::make_shared<ReplyTrace>();
+    trace->sentUs = Tracer::instance().nowUs();
+    connect(reply, &QNetworkReply::metaDataChanged, this, [trace]() {
+        if (trace->firstByteUs < 0) trace->firstByteUs = Tracer::instance().nowUs();
+    });
+    if (pending.onData) {
+        connect(reply, &QNetworkReply::readyRead, this, [this, reply, trace, onData = pending.onData]() {
+            QByteArray chunk = reply->readAll();
+            engine->received.fetchAndAddRelaxed(chunk.size());
+            trace->bytes += chunk.size();
+            int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+            if (status == 429) return;
+            if (!onData(chunk, status)) reply->abort();
+        });
+    }
+    if (pending.onProgress) {
+        connect(reply, &QNetworkReply::downloadProgress, this, [onProgress = pending.onProgress](qint64 r, qint64 t) { onProgress(r, t); });
+    }
+    connect(reply, &QNetworkReply::finished, this, [this, reply, pending, queue, trace, cancelSubscription]() mutable {
+        liveReplies.remove(reply);
+        pending.token.unsubscribe(cancelSubscription);
+        HttpResponse response;
+        response.error = reply->error();
+        response.errorString = response.ok() ? QString() : reply->errorString();
+        if (response.error == QNetworkReply::OperationCanceledError && pending.token.isCancelled()) response.errorString = "Cancelled";
+        response.statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        response.headers = reply->rawHeaderPairs();
+        QByteArray rest = reply->readAll();
+        engine->received.fetchAndAddRelaxed(rest.size());
+        trace->bytes += rest.size();
+        reply->deleteLater();
+        record(pending, *trace, response.statusCode);
+        if (retryIfRateLimited(response, pending, queue)) return;
+        if (!pending.onData) {
+            response.body = rest;
+        } else if (!rest.isEmpty() && response.ok()) {
+            pending.onData(rest, response.statusCode);
+        }
+        pending.onFinished(response);
+    });
+}
+
+HttpEngine::HttpEngine() : dispatcher(new HttpDispatcher(this)) {
+    thread.setObjectName("CraftPacker-Network");
+    dispatcher->moveToThread(&thread);
+    QObject::connect(&thread, &QThread::finished, dispatcher, &QObject::deleteLater);
+    thread.start();
+}
+
+HttpEngine::~HttpEngine() {
+    stop();
+}
+
+void HttpEngine::stop() {
+    thread.quit();
+    thread.wait();
+}
+
+QNetworkRequest HttpEngine::prepare(const QNetworkRequest& request) const {
+    QNetworkRequest prepared(request);
+    if (!prepared.hasRawHeader("User-Agent")) prepared.setRawHeader("User-Agent", USER_AGENT);
+    prepared.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    if (prepared.transferTimeout() == 0) prepared.setTransferTimeout(transferTimeoutMs.loadRelaxed());
+    return prepared;
+}
+
+void HttpEngine::deliver(QObject* context, const Callback& callback, const HttpResponse& response) {
+    if (context) {
+        QMetaObject::invokeMethod(context, [callback, response]() { callback(response); }, Qt::QueuedConnection);
+    } else {
+        callback(response);
+    }
+}
+
+void HttpEngine::get(const QNetworkRequest& request, QObject* context, Callback onFinished) {
+    download(request, nullptr, nullptr, context, std::move(onFinished));
+}
+
+QFuture<HttpResponse> HttpEngine::get(const QNetworkRequest& request) {
+    auto promise = std::make_shared<QPromise<HttpResponse>>();
+    promise->start();
+    QFuture<HttpResponse> future = promise->future();
+    get(request, nullptr, [promise](const HttpResponse& response) {
+        promise->addResult(response);
+        promise->finish();
+    });
+    return future;
+}
+
+HttpResponse HttpEngine::fetch(const QNetworkRequest& request) {
+    Q_ASSERT(QThread::currentThread() != &thread);
+    return get(request).result();
+}
+
+QFuture<HttpResponse> HttpEngine::post(const QNetworkRequest& request, const QByteArray& body) {
+    auto promise = std::make_shared<QPromise<HttpResponse>>();
+    promise->start();
+    QFuture<HttpResponse> future = promise->future();
+    PendingRequest pending;
+    pending.request = prepare(request);
+    pending.request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    pending.body = body;
+    pending.post = true;
+    pending.token = CancellationToken::current();
+    pending.enqueuedUs = Tracer::instance().nowUs();
+    pending.onFinished = [promise](const HttpResponse& response) {
+        promise->addResult(response);
+        promise->finish();
+    };
+    QMetaObject::invokeMethod(dispatcher, [this, pending]() { dispatcher->enqueue(pending); }, Qt::QueuedConnection);
+    return future;
+}
+
+void HttpEngine::setRateLimiter(const QString& host, RateLimiter* limiter) {
+    QMetaObject::invokeMethod(dispatcher, [this, host, limiter]() { dispatcher->setRateLimiter(host, limiter); }, Qt::QueuedConnection);
+}
+
+int HttpEngine::callAt(QDeadlineTimer deadline, std::function<void()> callback) {
+    int id = lastCallId.fetchAndAddRelaxed(1) + 1;
+    QMetaObject::invokeMethod(dispatcher, [this, id, deadline, callback]() { dispatcher->callAt(id, deadline, callback); }, Qt::QueuedConnection);
+    return id;
+}
+
+void HttpEngine::cancelCall(int id) {
+    QMetaObject::invokeMethod(dispatcher, [this, id]() { dispatcher->cancelCall(id); }, Qt::QueuedConnection);
+}
+
+void HttpEngine::download(const QNetworkRequest& request, DataCallback onData, ProgressCallback onProgress, QObject* context, Callback onFinished) {
+    QPointer<QObject> guard(context);
+    bool queued = context != nullptr;
+    PendingRequest pending;
+    pending.request = prepare(request);
+    pending.onData = onData;
+    pending.onProgress = onProgress;
+    pending.token = CancellationToken::current();
+    pending.enqueuedUs = Tracer::instance().nowUs();
+    pending.onFinished = [guard, queued, onFinished](const HttpResponse& response) {
+        if (!queued) deliver(nullptr, onFinished, response);
+        else if (guard) deliver(guard.data(), onFinished, response);
+    };
+    QMetaObject::invokeMethod(dispatcher, [this, pending]() { dispatcher->enqueue(pending); }, Qt::QueuedConnection);
+}
@@ -0,0 +1,87 @@
+#ifndef HTTPENGINE_H
+#define HTTPENGINE_H
+
+#include <QObject>
+#include <QFuture>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QThread>
+#include <QAtomicInteger>
+#include <functional>
+#include "CancellationToken.h"
+#include "RateLimiter.h"
+
+QT_BEGIN_NAMESPACE
+class QNetworkAccessManager;
+QT_END_NAMESPACE
+
+struct HttpResponse {
+    QNetworkReply::NetworkError error = QNetworkReply::UnknownNetworkError;
+    QString errorString;
+    int statusCode = 0;
+    QByteArray body;
+    QList<QNetworkReply::RawHeaderPair> headers;
+
+    bool ok() const { return error == QNetworkReply::NoError; }
+    QByteArray header(const QByteArray& name) const;
+};
+
+class HttpDispatcher;
+
+// One long-lived network thread owning a single QNetworkAccessManager, so every
+// request shares its keep-alive/HTTP/2 connection pool. Callbacks run on the
+// network thread unless a context object is given, in which case they are
+// queued to that object's thread (like QObject::connect with a context).
+// Every request carries the caller's CancellationToken::current(): cancelling it drops the request if it is
+// still queued and aborts it if it is in flight, and its deadline bounds the request. Either way the request
+// finishes with OperationCanceledError, so blocking waits on it always return.
+class HttpEngine {
+public:
+    using Callback = std::function<void(const HttpResponse&)>;
+    using DataCallback = std::function<bool(const QByteArray& chunk, int statusCode)>;
+    using ProgressCallback = std::function<void(qint64, qint64)>;
+
+    HttpEngine();
+    ~HttpEngine();
+    // Finishes the network thread; nothing runs on it afterwards. Lets an owner stop callbacks into objects
+    // that are destroyed before the engine. Also done by the destructor.
+    void stop();
+
+    void get(const QNetworkRequest& request, QObject* context, Callback onFinished);
+    QFuture<HttpResponse> get(const QNetworkRequest& request);
+    // Blocks the calling thread until the reply is complete. Never call this from the network thread.
+    HttpResponse fetch(const QNetworkRequest& request);
+    // POST with a JSON body. Goes through the same per-host queue and limiter as GET.
+    QFuture<HttpResponse> post(const QNetworkRequest& request, const QByteArray& body);
+    // Streams the body through onData (network thread) instead of buffering it. Returning false from onData aborts.
+    void download(const QNetworkRequest& request, DataCallback onData, ProgressCallback onProgress, QObject* context, Callback onFinished);
+
+    // Aborts a request after this long without receiving any bytes, whether connecting or mid-transfer.
+    // Applies to requests that don't set their own transfer timeout.
+    void setTransferTimeout(int ms) { transferTimeoutMs.storeRelaxed(qMax(1, ms)); }
+
+    // Requests to this host are queued by QNetworkRequest::priority() and released by the limiter.
+    void setRateLimiter(const QString& host, RateLimiter* limiter);
+    // Runs callback on the network thread once deadline has passed. A token's deadline runs no subscribers,
+    // so code that must react to one rather than poll for it schedules this. Returns an id for cancelCall().
+    int callAt(QDeadlineTimer deadline, std::function<void()> callback);
+    // Drops a callback that has not run yet, and whatever it captured, without waiting for its deadline.
+    void cancelCall(int id);
+
+    qint64 requestCount() const { return requests.loadRelaxed(); }
+    qint64 bytesReceived() const { return received.loadRelaxed(); }
+
+private:
+    friend class HttpDispatcher;
+    QNetworkRequest prepare(const QNetworkRequest& request) const;
+    static void deliver(QObject* context, const Callback& callback, const HttpResponse& response);
+
+    QThread thread;
+    HttpDispatcher* dispatcher;
+    QAtomicInteger<qint64> requests;
+    QAtomicInteger<qint64> received;
+    QAtomicInteger<int> lastCallId{0};
+    QAtomicInteger<int> transferTimeoutMs{30000};
+};
+
+#endif // HTTPENGINE_H
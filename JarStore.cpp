@@ -0,0 +1,219 @@
+#include "JarStore.h"
+#include "FileHash.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QSaveFile>
+
+#if defined(Q_OS_WIN)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+#if defined(Q_OS_LINUX)
+#include <linux/fs.h>
+#endif
+#if defined(Q_OS_MACOS)
+#include <sys/clonefile.h>
+#endif
+
+const quint32 STORE_MAGIC = 0x43504A53; // "CPJS"
+const quint32 STORE_FORMAT = 1;
+const QString REFERENCES_FILE = "references.bin";
+
+// Copy-on-write clone: no extra disk, and editing one side never changes the other. Needs btrfs, XFS or APFS.
+static bool reflink(const QString& source, const QString& target) {
+#if defined(Q_OS_LINUX) && defined(FICLONE)
+    int in = ::open(QFile::encodeName(source).constData(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) return false;
+    int out = ::open(QFile::encodeName(target).constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (out < 0) {
+        ::close(in);
+        return false;
+    }
+    bool ok = ::ioctl(out, FICLONE, in) == 0;
+    ::close(out);
+    ::close(in);
+    if (!ok) QFile::remove(target);
+    return ok;
+#elif defined(Q_OS_MACOS)
+    return ::clonefile(QFile::encodeName(source).constData(), QFile::encodeName(target).constData(), 0) == 0;
+#else
+    Q_UNUSED(source);
+    Q_UNUSED(target);
+    return false;
+#endif
+}
+
+// Pack files are only ever replaced, never written in place, so sharing the inode with the blob is safe.
+static bool hardlink(const QString& source, const QString& target) {
+#if defined(Q_OS_WIN)
+    return CreateHardLinkW(reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(target).utf16()),
+                           reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(source).utf16()), nullptr);
+#else
+    return ::link(QFile::encodeName(source).constData(), QFile::encodeName(target).constData()) == 0;
+#endif
+}
+
+static JarStore::Method cloneFile(const QString& source, const QString& target) {
+    if (reflink(source, target)) return JarStore::Method::Reflink;
+    if (hardlink(source, target)) return JarStore::Method::Hardlink;
+    if (QFile::copy(source, target)) return JarStore::Method::Copy;
+    return JarStore::Method::None;
+}
+
+JarStore::JarStore(const QString& directory) : directory(directory) {
+    QDir().mkpath(directory + "/blobs");
+    load();
+}
+
+JarStore::~JarStore() { save(); }
+
+QString JarStore::keyFor(const ModInfo& mod) {
+    if (!mod.sha512.isEmpty()) return "sha512-" + mod.sha512;
+    if (!mod.sha1.isEmpty()) return "sha1-" + mod.sha1;
+    return QString();
+}
+
+QString JarStore::blobPath(const QString& key) const {
+    // Fan out on the first two hex digits so no directory grows to tens of thousands of entries.
+    return directory + "/blobs/" + key.mid(key.indexOf('-') + 1, 2) + "/" + key;
+}
+
+// A blob is hashed against its name the first time it is linked in a session. Pack files may be hardlinks to
+// their blob, so a jar modified in place in one pack would otherwise spread to every pack placed from it.
+bool JarStore::verifyBlob(const QString& key, const QString& blob, qint64 size) {
+    {
+        QMutexLocker locker(&mutex);
+        if (verified.contains(key)) return true;
+    }
+    QString digest = key.mid(key.indexOf('-') + 1);
+    bool sha512 = key.startsWith("sha512-");
+    if (!fileMatches(blob, size, sha512 ? QString() : digest, sha512 ? digest : QString())) {
+        QFile::remove(blob);
+        return false;
+    }
+    QMutexLocker locker(&mutex);
+    verified.insert(key);
+    return true;
+}
+
+JarStore::Method JarStore::provide(const ModInfo& mod, const QString& dir) {
+    if (fileMatches(dir + "/" + mod.filename, mod.size, mod.sha1, mod.sha512)) {
+        adopt(mod, dir + "/" + mod.filename);
+        return Method::Present;
+    }
+    return place(mod, dir);
+}
+
+JarStore::Method JarStore::place(const ModInfo& mod, const QString& dir) {
+    QString key = keyFor(mod);
+    if (!isEnabled() || key.isEmpty()) return Method::None;
+    QReadLocker blobLocker(&blobLock);
+    QString blob = blobPath(key);
+    QFileInfo info(blob);
+    if (!info.exists() || (mod.size > 0 && info.size() != mod.size)) return Method::None;
+    if (!verifyBlob(key, blob, mod.size)) return Method::None;
+    QDir().mkpath(dir);
+    QString target = dir + "/" + mod.filename;
+    // Cloned under the download's .part name and renamed, so a pack never shows a half-copied jar.
+    QString temp = target + ".part";
+    QFile::remove(temp);
+    Method method = cloneFile(blob, temp);
+    if (method == Method::None) return method;
+    QFile::remove(target);
+    if (!QFile::rename(temp, target)) {
+        QFile::remove(temp);
+        return Method::None;
+    }
+    addReference(key, target);
+    placed.fetchAndAddRelaxed(1);
+    placedSize.fetchAndAddRelaxed(info.size());
+    return method;
+}
+
+void JarStore::adopt(const ModInfo& mod, const QString& path) {
+    QString key = keyFor(mod);
+    if (!isEnabled() || key.isEmpty()) return;
+    QReadLocker blobLocker(&blobLock);
+    QString blob = blobPath(key);
+    if (!QFileInfo::exists(blob)) {
+        QDir().mkpath(QFileInfo(blob).path());
+        QString temp = blob + ".tmp" + QString::number(QRandomGenerator::global()->generate(), 16);
+        if (cloneFile(path, temp) == Method::None) return;
+        // Someone else may have stored the same blob meanwhile; theirs is just as good.
+        if (!QFile::rename(temp, blob)) {
+            QFile::remove(temp);
+            if (!QFileInfo::exists(blob)) return;
+        }
+    }
+    addReference(key, path);
+}
+
+void JarStore::addReference(const QString& key, const QString& path) {
+    QString file = QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+    QMutexLocker locker(&mutex);
+    QSet<QString>& files = references[key];
+    if (files.contains(file)) return;
+    files.insert(file);
+    dirty = true;
+}
+
+qint64 JarStore::collectGarbage() {
+    QWriteLocker blobLocker(&blobLock);
+    QMutexLocker locker(&mutex);
+    // A reference is live while its file exists with the blob's size. Packs only ever hold verified files,
+    // so a same-sized replacement would have to be a different jar of exactly the same length.
+    QHash<QString, QSet<QString>> live;
+    for (auto it = references.constBegin(); it != references.constEnd(); ++it) {
+        qint64 size = QFileInfo(blobPath(it.key())).size();
+        for (const QString& file : it.value()) {
+            QFileInfo info(file);
+            if (info.exists() && info.size() == size) live[it.key()].insert(file);
+        }
+    }
+    qint64 freed = 0;
+    QDirIterator blobs(directory + "/blobs", QDir::Files, QDirIterator::Subdirectories);
+    while (blobs.hasNext()) {
+        QFileInfo info(blobs.next());
+        if (live.contains(info.fileName())) continue;
+        if (QFile::remove(info.filePath())) freed += info.size();
+        verified.remove(info.fileName());
+    }
+    if (live != references) dirty = true;
+    references = live;
+    return freed;
+}
+
+void JarStore::load() {
+    QFile file(directory + "/" + REFERENCES_FILE);
+    if (!file.open(QIODevice::ReadOnly)) return;
+    QDataStream in(&file);
+    quint32 magic = 0, format = 0;
+    QHash<QString, QSet<QString>> stored;
+    in >> magic >> format;
+    if (magic != STORE_MAGIC || format != STORE_FORMAT) return;
+    in >> stored;
+    if (in.status() != QDataStream::Ok) return;
+    QMutexLocker locker(&mutex);
+    references = stored;
+}
+
+bool JarStore::save() {
+    QMutexLocker locker(&mutex);
+    if (!dirty) return true;
+    QSaveFile file(directory + "/" + REFERENCES_FILE);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    QDataStream out(&file);
+    out << STORE_MAGIC << STORE_FORMAT << references;
+    if (!file.commit()) return false;
+    dirty = false;
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef JARSTORE_H
+#define JARSTORE_H
+
+#include <QAtomicInteger>
+#include <QHash>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QString>
+#include "ModrinthClient.h"
+
+// Content-addressed store of every jar downloaded on this machine, shared by all pack folders. Blobs are
+// named by their SHA-512 (SHA-1 when that is all a mod has) under <directory>/blobs, and pack folders get
+// a reflink, a hardlink or, failing both, a copy of the blob. Each blob keeps the set of pack files made
+// from it; collectGarbage() drops references whose file is gone and deletes blobs nobody refers to.
+// Safe to use from several threads. Linking and adopting files block collectGarbage() until their reference
+// is recorded, and it blocks them while it runs.
+class JarStore {
+public:
+    // How provide() or place() got the file into the pack folder. Present: it was already there.
+    enum class Method { None, Present, Reflink, Hardlink, Copy };
+
+    explicit JarStore(const QString& directory);
+    ~JarStore();
+
+    // When disabled, provide() only checks the pack folder and adopt() does nothing.
+    void setEnabled(bool on) { enabled.storeRelaxed(on); }
+    bool isEnabled() const { return enabled.loadRelaxed(); }
+
+    // Makes sure dir holds this exact file without touching the network. A file that is already there is
+    // adopted, so existing packs seed the store. Method::None means it still has to be downloaded.
+    Method provide(const ModInfo& mod, const QString& dir);
+    // Puts a blob into dir under the mod's filename. Method::None if the store doesn't have it, or if the blob
+    // no longer matches its hash, in which case it is deleted.
+    Method place(const ModInfo& mod, const QString& dir);
+    // Records a verified file in a pack folder, copying it into the store first if its blob is missing.
+    void adopt(const ModInfo& mod, const QString& path);
+
+    // Returns the number of bytes freed.
+    qint64 collectGarbage();
+    bool save();
+
+    // Files placed from the store instead of downloaded, and their total size.
+    qint64 placedFiles() const { return placed.loadRelaxed(); }
+    qint64 placedBytes() const { return placedSize.loadRelaxed(); }
+
+private:
+    static QString keyFor(const ModInfo& mod);
+    QString blobPath(const QString& key) const;
+    bool verifyBlob(const QString& key, const QString& blob, qint64 size);
+    void addReference(const QString& key, const QString& path);
+    void load();
+
+    QString directory;
+    QAtomicInteger<bool> enabled{true};
+    // Read-locked from checking a blob until its reference is recorded; write-locked by collectGarbage().
+    QReadWriteLock blobLock;
+    QMutex mutex;
+    QHash<QString, QSet<QString>> references;
+    // Blobs hashed since the store was opened.
+    QSet<QString> verified;
+    bool dirty = false;
+    QAtomicInteger<qint64> placed{0};
+    QAtomicInteger<qint64> placedSize{0};
+};
+
+#endif // JARSTORE_H
@@ -0,0 +1,62 @@
+#include "MatrixResolver.h"
+
+#include <QRegularExpression>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <vector>
+
+MatrixResolver::MatrixResolver(ModrinthClient* modrinth, NameIndex* index)
+    : modrinth(modrinth), index(index), maxThreads(QThread::idealThreadCount()) {}
+
+std::optional<PackTarget> MatrixResolver::parseTarget(const QString& text) {
+    static const QRegularExpression separator(R"([:\s]+)");
+    QStringList parts = text.trimmed().split(separator, Qt::SkipEmptyParts);
+    if (parts.size() != 2) return std::nullopt;
+    return PackTarget{parts[0].toLower(), parts[1]};
+}
+
+QList<TargetResolution> MatrixResolver::resolve(const QStringList& names, const QList<PackTarget>& targets) {
+    QList<TargetResolution> results(targets.size());
+    for (int t = 0; t < targets.size(); ++t) results[t].target = targets[t];
+    tags.clear();
+
+    // Workers run under the caller's cancellation token.
+    CancellationToken token = CancellationToken::current();
+    std::vector<ModSearch::TargetsResult> searches(names.size());
+    QThreadPool pool;
+    pool.setMaxThreadCount(maxThreads);
+    for (int i = 0; i < names.size(); ++i) {
+        pool.start([this, &searches, &names, &targets, token, i]() {
+            CancellationScope scope(token);
+            searches[i] = ModSearch(modrinth, index).findForTargets(names.at(i), targets);
+        });
+    }
+    pool.waitForDone();
+
+    QList<QList<ModInfo>> roots(targets.size());
+    QList<QSet<QString>> rootProjects(targets.size());
+    for (int i = 0; i < names.size(); ++i) {
+        const ModSearch::TargetsResult& search = searches[i];
+        for (int t = 0; t < targets.size(); ++t) {
+            const std::optional<ModInfo>& mod = search.mods.value(t);
+            if (!mod) { results[t].notFound.append(names[i]); continue; }
+            results[t].found.insert(names[i], *mod);
+            tags.insert(mod->projectId, search.tag);
+            if (rootProjects[t].contains(mod->projectId)) continue;
+            rootProjects[t].insert(mod->projectId);
+            roots[t].append(*mod);
+        }
+    }
+
+    // Targets that share dependencies share their bulk lookups through the client's cache and in-flight coalescing.
+    TargetResolution* out = results.data();
+    for (int t = 0; t < targets.size(); ++t) {
+        pool.start([this, out, &roots, token, t]() {
+            CancellationScope scope(token);
+            out[t].resolution = DependencyResolver(modrinth).resolve(roots.at(t), out[t].target.loader, out[t].target.gameVersion);
+        });
+    }
+    pool.waitForDone();
+    return results;
+}
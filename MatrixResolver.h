@@ -0,0 +1,37 @@
+#ifndef MATRIXRESOLVER_H
+#define MATRIXRESOLVER_H
+
+#include "DependencyResolver.h"
+#include "ModSearch.h"
+
+struct TargetResolution {
+    PackTarget target;
+    // The requested mods that have a build for this target, keyed by the name from the list.
+    QHash<QString, ModInfo> found;
+    QStringList notFound;
+    ResolutionResult resolution;
+};
+
+// Resolves one mod list for several loader and game version targets in a single pass. Each name is searched
+// once for all targets and each project's version list is fetched once and filtered per target; dependencies
+// are then resolved for every target concurrently. Blocking; call from a worker thread.
+class MatrixResolver {
+public:
+    explicit MatrixResolver(ModrinthClient* modrinth, NameIndex* index = nullptr);
+    void setMaxThreads(int n) { maxThreads = qMax(1, n); }
+
+    QList<TargetResolution> resolve(const QStringList& names, const QList<PackTarget>& targets);
+    // Match tag per project id ("found" or "fallback"), from the last resolve().
+    const QHash<QString, QString>& searchTags() const { return tags; }
+
+    // Parses "fabric:1.20.1" (or "fabric 1.20.1"); returns nullopt for anything else.
+    static std::optional<PackTarget> parseTarget(const QString& text);
+
+private:
+    ModrinthClient* modrinth;
+    NameIndex* index;
+    int maxThreads;
+    QHash<QString, QString> tags;
+};
+
+#endif // MATRIXRESOLVER_H
@@ -0,0 +1,143 @@
+#include "MetadataCache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <algorithm>
+
+const quint32 CACHE_FORMAT = 1;
+
+static QString fileNameFor(const QString& key) {
+    return QString::fromLatin1(QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex()) + ".bin";
+}
+
+MetadataCache::MetadataCache(const QString& directory, int ttlMinutes, qint64 maxBytes) : directory(directory), ttlMinutes(ttlMinutes), maxBytes(maxBytes) {
+    // One writer keeps writes and deletes of the same file in the order they were queued.
+    writer.setMaxThreadCount(1);
+    QDir().mkpath(directory);
+    QFileInfoList files = QDir(directory).entryInfoList({"*.bin"}, QDir::Files);
+    std::sort(files.begin(), files.end(), [](const QFileInfo& a, const QFileInfo& b) { return a.lastModified() > b.lastModified(); });
+    for (const QFileInfo& fi : files) {
+        lru.push_back(fi.fileName());
+        index.insert(fi.fileName(), {fi.size(), std::prev(lru.end())});
+        totalBytes += fi.size();
+    }
+}
+
+MetadataCache::~MetadataCache() {
+    writer.waitForDone();
+}
+
+void MetadataCache::setTtlMinutes(int minutes) { QMutexLocker locker(&mutex); ttlMinutes = minutes; }
+
+void MetadataCache::setMaxBytes(qint64 bytes) {
+    QMutexLocker locker(&mutex);
+    maxBytes = bytes;
+    QStringList victims = evict();
+    if (!victims.isEmpty()) writer.start([this, victims]() { removeFiles(victims); });
+}
+
+void MetadataCache::flush() {
+    writer.waitForDone();
+}
+
+void MetadataCache::touch(const QString& name) {
+    auto it = index.find(name);
+    if (it != index.end()) lru.splice(lru.begin(), lru, it->use);
+}
+
+std::optional<MetadataCache::Entry> MetadataCache::lookup(const QString& key) {
+    QString name = fileNameFor(key);
+    int ttl;
+    {
+        QMutexLocker locker(&mutex);
+        ttl = ttlMinutes;
+        auto queued = pending.constFind(name);
+        if (queued != pending.constEnd() && queued->key == key) {
+            Entry entry{queued->body, queued->etag, QDateTime::fromMSecsSinceEpoch(queued->fetchedMs)};
+            entry.fresh = entry.fetched.secsTo(QDateTime::currentDateTimeUtc()) < qint64(ttl) * 60;
+            return entry;
+        }
+        if (!index.contains(name)) return std::nullopt;
+        touch(name);
+    }
+    QFile file(directory + "/" + name);
+    if (!file.open(QIODevice::ReadOnly)) return std::nullopt;
+    QDataStream in(&file);
+    quint32 format = 0;
+    QString storedKey;
+    qint64 fetchedMs = 0;
+    Entry entry;
+    in >> format >> storedKey >> entry.etag >> fetchedMs >> entry.body;
+    if (in.status() != QDataStream::Ok || format != CACHE_FORMAT || storedKey != key) return std::nullopt;
+    entry.fetched = QDateTime::fromMSecsSinceEpoch(fetchedMs);
+    entry.fresh = entry.fetched.secsTo(QDateTime::currentDateTimeUtc()) < qint64(ttl) * 60;
+    return entry;
+}
+
+void MetadataCache::store(const QString& key, const QByteArray& body, const QByteArray& etag) {
+    QString name = fileNameFor(key);
+    PendingWrite write{key, body, etag, QDateTime::currentDateTimeUtc().toMSecsSinceEpoch(), 0};
+    {
+        QMutexLocker locker(&mutex);
+        write.generation = ++nextGeneration;
+        pending.insert(name, write);
+    }
+    writer.start([this, name, write]() { this->write(name, write); });
+}
+
+// Runs on the writer thread.
+void MetadataCache::write(const QString& name, const PendingWrite& write) {
+    QSaveFile file(directory + "/" + name);
+    qint64 size = -1;
+    if (file.open(QIODevice::WriteOnly)) {
+        QDataStream out(&file);
+        out << CACHE_FORMAT << write.key << write.etag << write.fetchedMs << write.body;
+        size = file.size();
+        if (!file.commit()) size = -1;
+    }
+    QStringList victims;
+    {
+        QMutexLocker locker(&mutex);
+        auto queued = pending.find(name);
+        if (queued != pending.end() && queued->generation == write.generation) pending.erase(queued);
+        if (size < 0) return;
+        auto it = index.find(name);
+        if (it != index.end()) {
+            totalBytes -= it->size;
+            it->size = size;
+            lru.splice(lru.begin(), lru, it->use);
+        } else {
+            lru.push_front(name);
+            index.insert(name, {size, lru.begin()});
+        }
+        totalBytes += size;
+        victims = evict();
+    }
+    removeFiles(victims);
+}
+
+QStringList MetadataCache::evict() {
+    QStringList victims;
+    while (totalBytes > maxBytes && !lru.empty()) {
+        QString name = lru.back();
+        lru.pop_back();
+        totalBytes -= index.take(name).size;
+        victims.append(name);
+    }
+    return victims;
+}
+
+// Runs on the writer thread, the only one that adds to the index, so a file written again after it was
+// evicted is left alone.
+void MetadataCache::removeFiles(const QStringList& names) {
+    for (const QString& name : names) {
+        {
+            QMutexLocker locker(&mutex);
+            if (index.contains(name)) continue;
+        }
+        QFile::remove(directory + "/" + name);
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef METADATACACHE_H
+#define METADATACACHE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QThreadPool>
+#include <QAtomicInteger>
+#include <list>
+#include <optional>
+
+// Persistent cache of API responses, one file per key. Entries older than the TTL are still returned
+// (marked stale) so the caller can revalidate them with If-None-Match instead of refetching.
+// Writes and evictions run on a private writer thread, so store() is cheap enough to call from the network
+// thread; until a write lands, lookup() answers from memory.
+class MetadataCache {
+public:
+    struct Entry {
+        QByteArray body;
+        QByteArray etag;
+        QDateTime fetched;
+        bool fresh = false;
+    };
+
+    MetadataCache(const QString& directory, int ttlMinutes = 360, qint64 maxBytes = 100 * 1024 * 1024);
+    ~MetadataCache();
+
+    std::optional<Entry> lookup(const QString& key);
+    void store(const QString& key, const QByteArray& body, const QByteArray& etag);
+    void setTtlMinutes(int minutes);
+    void setMaxBytes(qint64 bytes);
+    // Blocks until every queued write and eviction has reached the disk.
+    void flush();
+
+    void recordHit() { hitCount.fetchAndAddRelaxed(1); }
+    void recordMiss() { missCount.fetchAndAddRelaxed(1); }
+    qint64 hits() const { return hitCount.loadRelaxed(); }
+    qint64 misses() const { return missCount.loadRelaxed(); }
+
+private:
+    struct IndexEntry {
+        qint64 size;
+        // Position in lru.
+        std::list<QString>::iterator use;
+    };
+    struct PendingWrite {
+        QString key;
+        QByteArray body;
+        QByteArray etag;
+        qint64 fetchedMs;
+        quint64 generation;
+    };
+    void write(const QString& name, const PendingWrite& pending);
+    void touch(const QString& name);
+    // Drops least recently used entries until the cache fits and returns their file names. Call with mutex held.
+    QStringList evict();
+    void removeFiles(const QStringList& names);
+
+    QString directory;
+    int ttlMinutes;
+    qint64 maxBytes;
+    qint64 totalBytes = 0;
+    QHash<QString, IndexEntry> index;
+    // File names, most recently used first.
+    std::list<QString> lru;
+    QHash<QString, PendingWrite> pending;
+    quint64 nextGeneration = 0;
+    QMutex mutex;
+    QThreadPool writer;
+    QAtomicInteger<qint64> hitCount;
+    QAtomicInteger<qint64> missCount;
+};
+
+#endif // METADATACACHE_H
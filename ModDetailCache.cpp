@@ -0,0 +1,234 @@
+#include "ModDetailCache.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QUrlQuery>
+
+const int MEMORY_CACHE_KIB = 32 * 1024;
+const int DETAILS_TTL_DAYS = 7;
+const int PREFETCH_BATCH_SIZE = 50;
+
+ImageSearchWorker::ImageSearchWorker(QString modName, QString projectId, HttpEngine* http) : m_modName(modName), m_projectId(projectId), m_http(http) {}
+void ImageSearchWorker::process() {
+    QString query = m_modName + " mod minecraft icon";
+    QUrl url("https://duckduckgo.com/i.js");
+    QUrlQuery urlQuery;
+    urlQuery.addQueryItem("l", "us-en");
+    urlQuery.addQueryItem("o", "json");
+    urlQuery.addQueryItem("q", query);
+    url.setQuery(urlQuery);
+    QNetworkRequest request(url);
+    request.setHeader(QNetworkRequest::UserAgentHeader, "Mozilla/5.0");
+    // Kept for the image request, which is sent from the callback where no scope is active.
+    m_token = CancellationToken::current();
+    m_http->get(request, this, [this](const HttpResponse& reply) {
+        if (!reply.ok()) { emit failed(m_projectId); return; }
+        QJsonArray results = QJsonDocument::fromJson(reply.body).object()["results"].toArray();
+        if (results.isEmpty()) { emit imageFound(m_projectId, QByteArray()); return; }
+        QString imageUrl = results[0].toObject()["image"].toString();
+        CancellationScope scope(m_token);
+        m_http->get(QNetworkRequest(QUrl(imageUrl)), this, [this](const HttpResponse& imageReply) {
+            if (imageReply.ok()) emit imageFound(m_projectId, imageReply.body);
+            else emit failed(m_projectId);
+        });
+    });
+}
+
+static int costOf(const ModDetails& details) {
+    return 1 + int(details.icon.sizeInBytes() / 1024);
+}
+
+static QImage thumbnail(const QImage& image) {
+    if (image.isNull() || (image.width() <= ModDetailCache::ICON_SIZE && image.height() <= ModDetailCache::ICON_SIZE)) return image;
+    return image.scaled(ModDetailCache::ICON_SIZE, ModDetailCache::ICON_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
+
+ModDetailCache::ModDetailCache(ModrinthClient* modrinth, HttpEngine* http, const QString& directory, QObject* parent)
+    : QObject(parent), modrinth(modrinth), http(http), directory(directory), memory(MEMORY_CACHE_KIB) {
+    QDir().mkpath(directory);
+}
+
+QString ModDetailCache::detailsPath(const QString& projectId) const { return directory + "/" + projectId + ".json"; }
+QString ModDetailCache::iconPath(const QString& projectId) const { return directory + "/" + projectId + ".png"; }
+
+const ModDetails* ModDetailCache::lookup(const QString& projectId) {
+    return memory.object(projectId);
+}
+
+// Runs in the pool.
+std::optional<ModDetails> ModDetailCache::readDetails(const QString& projectId) const {
+    QFileInfo info(detailsPath(projectId));
+    if (!info.exists() || info.lastModified().daysTo(QDateTime::currentDateTime()) > DETAILS_TTL_DAYS) return std::nullopt;
+    QFile file(info.filePath());
+    if (!file.open(QIODevice::ReadOnly)) return std::nullopt;
+    QJsonObject json = QJsonDocument::fromJson(file.readAll()).object();
+    ModDetails details;
+    details.author = json["author"].toString();
+    details.description = json["description"].toString();
+    details.iconUrl = json["iconUrl"].toString();
+    details.icon = QImage(iconPath(projectId));
+    // A missing thumbnail is fetched again on the next request rather than treated as "no icon".
+    details.iconLoaded = !details.icon.isNull();
+    return details;
+}
+
+// Runs in the pool.
+ModDetails ModDetailCache::writeDetails(const QString& projectId, const QJsonObject& project) const {
+    ModDetails details;
+    details.author = project["author"].toString();
+    details.description = project["description"].toString();
+    details.iconUrl = project["icon_url"].toString();
+    QSaveFile file(detailsPath(projectId));
+    if (file.open(QIODevice::WriteOnly)) {
+        QJsonObject json{{"author", details.author}, {"description", details.description}, {"iconUrl", details.iconUrl}};
+        file.write(QJsonDocument(json).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+    return details;
+}
+
+void ModDetailCache::storeDetails(const QString& projectId, ModDetails details) {
+    // An icon that arrived while these were being read or fetched is newer than whatever came with them.
+    if (const ModDetails* previous = memory.object(projectId); previous && previous->iconLoaded) {
+        details.icon = previous->icon;
+        details.iconLoaded = true;
+    }
+    memory.insert(projectId, new ModDetails(details), costOf(details));
+}
+
+void ModDetailCache::storeIcon(const QString& projectId, const QImage& icon) {
+    iconsInFlight.remove(projectId);
+    const ModDetails* current = lookup(projectId);
+    auto details = new ModDetails(current ? *current : ModDetails());
+    details->icon = icon;
+    details->iconLoaded = true;
+    details->iconFailed = false;
+    memory.insert(projectId, details, costOf(*details));
+    emit updated(projectId);
+}
+
+// A failed or cancelled download is not cached, so the next request for the project tries again.
+void ModDetailCache::dropIcon(const QString& projectId) {
+    iconsInFlight.remove(projectId);
+    ModDetails* details = memory.object(projectId);
+    if (!details || details->iconLoaded) return;
+    details->iconFailed = true;
+    emit updated(projectId);
+}
+
+void ModDetailCache::request(const QString& projectId, const QString& name) {
+    panelWanted = projectId;
+    panelWantedName = name;
+    if (projectId != panelProject) panelToken.cancel();
+    if (!panelBusy) startPanelFetch();
+}
+
+void ModDetailCache::startPanelFetch() {
+    QString projectId = panelWanted;
+    QString name = panelWantedName;
+    panelWanted.clear();
+    if (projectId.isEmpty()) return;
+    if (projectId != panelProject || panelToken.isCancelled()) {
+        panelProject = projectId;
+        panelToken = CancellationToken::create();
+    }
+    CancellationScope scope(panelToken);
+    if (const ModDetails* details = lookup(projectId)) {
+        if (!details->iconLoaded) fetchIcon(projectId, name, QNetworkRequest::HighPriority, true);
+        return;
+    }
+    // Selections made while this is in flight only update panelWanted, so scrolling through a list
+    // sends one request for where the user stopped rather than one per row passed.
+    panelBusy = true;
+    QThreadPool::globalInstance()->start([this, projectId, name, token = panelToken]() {
+        CancellationScope scope(token);
+        std::optional<ModDetails> details = readDetails(projectId);
+        if (!details && !token.isCancelled()) {
+            auto doc = modrinth->getJson(QUrl(modrinth->apiBase() + "/project/" + projectId), QNetworkRequest::HighPriority);
+            if (doc && doc->isObject() && !doc->object().isEmpty()) details = writeDetails(projectId, doc->object());
+        }
+        QMetaObject::invokeMethod(this, [this, projectId, name, token, details]() {
+            panelBusy = false;
+            if (details) {
+                storeDetails(projectId, *details);
+                emit updated(projectId);
+                CancellationScope scope(token);
+                fetchIcon(projectId, name, QNetworkRequest::HighPriority, true);
+            }
+            startPanelFetch();
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ModDetailCache::prefetch(const QStringList& projectIds) {
+    QStringList missingDetails;
+    for (const QString& id : projectIds) {
+        const ModDetails* details = lookup(id);
+        if (!details && !detailsInFlight.contains(id)) missingDetails.append(id);
+        else if (details && !details->iconLoaded && !details->iconUrl.isEmpty()) fetchIcon(id, QString(), QNetworkRequest::LowPriority, false);
+    }
+    for (int i = 0; i < missingDetails.size(); i += PREFETCH_BATCH_SIZE) {
+        QStringList batch = missingDetails.mid(i, PREFETCH_BATCH_SIZE);
+        for (const QString& id : batch) detailsInFlight.insert(id);
+        QThreadPool::globalInstance()->start([this, batch]() {
+            QHash<QString, ModDetails> found;
+            QStringList stale;
+            for (const QString& id : batch) {
+                if (auto details = readDetails(id)) found.insert(id, *details);
+                else stale.append(id);
+            }
+            if (!stale.isEmpty()) {
+                const QHash<QString, QJsonObject> projects = modrinth->getProjects(stale, QNetworkRequest::LowPriority);
+                for (auto it = projects.begin(); it != projects.end(); ++it) found.insert(it.key(), writeDetails(it.key(), it.value()));
+            }
+            QMetaObject::invokeMethod(this, [this, batch, found]() {
+                for (const QString& id : batch) {
+                    detailsInFlight.remove(id);
+                    if (!found.contains(id)) continue;
+                    storeDetails(id, found.value(id));
+                    emit updated(id);
+                    fetchIcon(id, QString(), QNetworkRequest::LowPriority, false);
+                }
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void ModDetailCache::fetchIcon(const QString& projectId, const QString& name, QNetworkRequest::Priority priority, bool searchWeb) {
+    ModDetails* details = memory.object(projectId);
+    if (!details || details->iconLoaded || iconsInFlight.contains(projectId)) return;
+    if (details->iconUrl.isEmpty()) {
+        if (!searchWeb) return;
+        details->iconFailed = false;
+        iconsInFlight.insert(projectId);
+        ImageSearchWorker* worker = new ImageSearchWorker(name, projectId, http);
+        connect(worker, &ImageSearchWorker::imageFound, this, &ModDetailCache::decodeIcon);
+        connect(worker, &ImageSearchWorker::failed, this, &ModDetailCache::dropIcon);
+        connect(worker, &ImageSearchWorker::imageFound, worker, &QObject::deleteLater);
+        connect(worker, &ImageSearchWorker::failed, worker, &QObject::deleteLater);
+        worker->process();
+        return;
+    }
+    details->iconFailed = false;
+    iconsInFlight.insert(projectId);
+    QNetworkRequest iconRequest{QUrl(details->iconUrl)};
+    iconRequest.setPriority(priority);
+    http->get(iconRequest, this, [this, projectId](const HttpResponse& reply) {
+        if (reply.ok()) decodeIcon(projectId, reply.body);
+        else dropIcon(projectId);
+    });
+}
+
+// Decoding, scaling and saving happen in the pool; only the thumbnail comes back to this thread. Empty data is
+// a search that found nothing, which is cached as "no icon" for this session.
+void ModDetailCache::decodeIcon(const QString& projectId, const QByteArray& data) {
+    QThreadPool::globalInstance()->start([this, projectId, data, path = iconPath(projectId)]() {
+        QImage icon = thumbnail(QImage::fromData(data));
+        if (!icon.isNull()) icon.save(path, "PNG");
+        QMetaObject::invokeMethod(this, [this, projectId, icon]() { storeIcon(projectId, icon); }, Qt::QueuedConnection);
+    });
+}
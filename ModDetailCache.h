@@ -0,0 +1,90 @@
+#ifndef MODDETAILCACHE_H
+#define MODDETAILCACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QImage>
+#include <QSet>
+#include <optional>
+#include "CancellationToken.h"
+#include "HttpEngine.h"
+#include "ModrinthClient.h"
+
+// Fallback for projects without an icon: takes the first DuckDuckGo image result for the mod's name.
+// Hands back the raw image bytes, empty when the search found nothing; failed requests report failed().
+class ImageSearchWorker : public QObject {
+    Q_OBJECT
+public:
+    ImageSearchWorker(QString modName, QString projectId, HttpEngine* http);
+public slots:
+    void process();
+signals:
+    void imageFound(const QString& projectId, const QByteArray& imageData);
+    void failed(const QString& projectId);
+private:
+    QString m_modName;
+    QString m_projectId;
+    HttpEngine* m_http;
+    CancellationToken m_token;
+};
+
+struct ModDetails {
+    QString author;
+    QString description;
+    QString iconUrl;
+    // Thumbnail scaled to fit ICON_SIZE. Null with iconLoaded set means the project has no icon.
+    QImage icon;
+    bool iconLoaded = false;
+    // The last attempt failed. Only kept in memory, and the next request() tries again.
+    bool iconFailed = false;
+};
+
+// What the details panel shows for a project, kept in a memory LRU in front of a directory of small
+// JSON and PNG files, so clicking back through results costs no requests. Panel requests go out at
+// high priority and only the latest selection is fetched; prefetch batches visible rows into one
+// /projects call and loads their icons at low priority. Lives on the GUI thread; reading and writing
+// the files and decoding icons happen in the global pool.
+class ModDetailCache : public QObject {
+    Q_OBJECT
+public:
+    static const int ICON_SIZE = 128;
+
+    ModDetailCache(ModrinthClient* modrinth, HttpEngine* http, const QString& directory, QObject* parent = nullptr);
+
+    // Memory only, so it is cheap enough for the GUI thread. request() and prefetch() load from disk or the
+    // network and emit updated() when something arrives.
+    const ModDetails* lookup(const QString& projectId);
+    // Fetches whatever the panel still lacks for this project. A newer call for another project replaces one
+    // that has not started yet and cancels one that has.
+    void request(const QString& projectId, const QString& name);
+    void prefetch(const QStringList& projectIds);
+
+signals:
+    void updated(const QString& projectId);
+
+private:
+    void startPanelFetch();
+    std::optional<ModDetails> readDetails(const QString& projectId) const;
+    ModDetails writeDetails(const QString& projectId, const QJsonObject& project) const;
+    void storeDetails(const QString& projectId, ModDetails details);
+    void fetchIcon(const QString& projectId, const QString& name, QNetworkRequest::Priority priority, bool searchWeb);
+    void decodeIcon(const QString& projectId, const QByteArray& data);
+    void storeIcon(const QString& projectId, const QImage& icon);
+    void dropIcon(const QString& projectId);
+    QString detailsPath(const QString& projectId) const;
+    QString iconPath(const QString& projectId) const;
+
+    ModrinthClient* modrinth;
+    HttpEngine* http;
+    QString directory;
+    QCache<QString, ModDetails> memory;
+    QSet<QString> detailsInFlight;
+    QSet<QString> iconsInFlight;
+    QString panelWanted;
+    QString panelWantedName;
+    QString panelProject;
+    CancellationToken panelToken;
+    bool panelBusy = false;
+};
+
+#endif // MODDETAILCACHE_H
@@ -0,0 +1,138 @@
+#include "ModSearch.h"
+
+#include <QRegularExpression>
+#include <QUrlQuery>
+#include <algorithm>
+
+const int SNAPSHOT_PAGE_SIZE = 100;
+
+ModSearch::ModSearch(ModrinthClient* modrinth, NameIndex* index) : modrinth(modrinth), index(index) {}
+
+ModSearch::Result ModSearch::find(const QString& name, const QString& loader, const QString& gameVersion) {
+    Result result;
+    auto accept = [&](const QString& projectId) {
+        result.mod = modrinth->getModInfo(projectId, loader, gameVersion);
+        return result.mod.has_value();
+    };
+    if (findProject(name, {loader}, {gameVersion}, accept, result.status, result.tag)) result.mod->originalQuery = name;
+    return result;
+}
+
+ModSearch::TargetsResult ModSearch::findForTargets(const QString& name, const QList<PackTarget>& targets) {
+    TargetsResult result;
+    QStringList loaders, gameVersions;
+    for (const auto& target : targets) {
+        if (!loaders.contains(target.loader)) loaders.append(target.loader);
+        if (!gameVersions.contains(target.gameVersion)) gameVersions.append(target.gameVersion);
+    }
+    // The first candidate with a build for any target wins, so every column of a row is the same project.
+    auto accept = [&](const QString& projectId) {
+        result.mods = modrinth->getModInfoForTargets(projectId, targets);
+        return std::any_of(result.mods.cbegin(), result.mods.cend(), [](const auto& mod) { return mod.has_value(); });
+    };
+    if (findProject(name, loaders, gameVersions, accept, result.status, result.tag)) {
+        for (auto& mod : result.mods) {
+            if (mod) mod->originalQuery = name;
+        }
+    } else {
+        result.mods = QList<std::optional<ModInfo>>(targets.size());
+    }
+    return result;
+}
+
+bool ModSearch::findProject(const QString& name, const QStringList& loaders, const QStringList& gameVersions,
+                            const std::function<bool(const QString&)>& accept, QString& status, QString& tag) {
+    QString cleanName = sanitizeModName(name);
+    if (CancellationToken::current().isCancelled()) return false;
+    // Only an exact slug, title or learned alias skips /search. Acronyms and fuzzy matches ("jei", "ae") are
+    // ambiguous, so they only reorder the hits /search returns and are never accepted without it.
+    QStringList hints;
+    if (index) {
+        for (const QString& projectId : index->lookup(cleanName)) {
+            if (accept(projectId)) {
+                status = "Available (Index)";
+                tag = "found";
+                return true;
+            }
+        }
+        hints = index->suggest(cleanName);
+    }
+    // Facets keep hits to projects that have a build for one of the loaders and game versions, so the first hit usually fits.
+    QJsonArray loaderFacet, versionFacet;
+    for (const QString& loader : loaders) loaderFacet.append("categories:" + loader);
+    for (const QString& gameVersion : gameVersions) versionFacet.append("versions:" + gameVersion);
+    QJsonArray facets{QJsonArray{"project_type:mod"}, loaderFacet, versionFacet};
+    QUrlQuery query;
+    query.addQueryItem("query", splitCamelCase(cleanName));
+    query.addQueryItem("limit", "5");
+    query.addQueryItem("facets", QJsonDocument(facets).toJson(QJsonDocument::Compact));
+    QUrl url(modrinth->apiBase() + "/search");
+    url.setQuery(query);
+    if (auto doc = modrinth->getJson(url)) {
+        QJsonArray hits = doc->object()["hits"].toArray();
+        if (index) index->addSearchHits(hits);
+        QStringList candidates;
+        for (const auto& hitVal : hits) candidates.append(hitVal.toObject()["project_id"].toString());
+        std::stable_sort(candidates.begin(), candidates.end(), [&hints](const QString& a, const QString& b) {
+            qsizetype rankA = hints.indexOf(a), rankB = hints.indexOf(b);
+            return rankA >= 0 && (rankB < 0 || rankA < rankB);
+        });
+        for (const QString& projectId : std::as_const(candidates)) {
+            if (accept(projectId)) {
+                status = "Available (API)";
+                tag = "found";
+                if (index) index->addAlias(cleanName, projectId);
+                return true;
+            }
+        }
+    }
+    if (CancellationToken::current().isCancelled()) return false;
+    static const QRegularExpression whitespace(R"(\s)");
+    QString slug = cleanName.toLower().replace(whitespace, "-");
+    if (accept(slug)) {
+        status = "Available (Slug)";
+        tag = "fallback";
+        return true;
+    }
+    return false;
+}
+
+// Compiled once and shared; QRegularExpression is safe to use from several threads.
+QString ModSearch::sanitizeModName(const QString& input) {
+    static const QRegularExpression loaderWords(R"(\b(fabric|forge|quilt|neoforge|\+1|mod)\b)", QRegularExpression::CaseInsensitiveOption);
+    static const QRegularExpression brackets(R"([\[\]\(\)])");
+    static const QRegularExpression versionSuffix(R"((?i)[-_]?(fabric|forge|quilt|neoforge)?[-_]?\d+(\.\d+)*([-_].*)?$)");
+    static const QRegularExpression separators("[-_]");
+    QString result = input;
+    result = result.remove(loaderWords);
+    result = result.remove(brackets);
+    result = result.remove(versionSuffix);
+    result = result.replace(separators, " ").trimmed();
+    return result.simplified();
+}
+
+QString ModSearch::splitCamelCase(const QString& input) {
+    static const QRegularExpression wordBoundary("(?<=[a-z])(?=[A-Z])|(?<=[A-Z])(?=[A-Z][a-z])");
+    QString temp = input;
+    return temp.replace(wordBoundary, " ");
+}
+
+int ModSearch::buildIndexSnapshot(int projects) {
+    if (!index) return 0;
+    int before = index->size();
+    QList<QFuture<HttpResponse>> pages;
+    for (int offset = 0; offset < projects; offset += SNAPSHOT_PAGE_SIZE) {
+        QUrlQuery query;
+        query.addQueryItem("index", "downloads");
+        query.addQueryItem("limit", QString::number(SNAPSHOT_PAGE_SIZE));
+        query.addQueryItem("offset", QString::number(offset));
+        query.addQueryItem("facets", R"([["project_type:mod"]])");
+        QUrl url(modrinth->apiBase() + "/search");
+        url.setQuery(query);
+        pages.append(modrinth->request(url, QNetworkRequest::LowPriority));
+    }
+    for (auto& page : pages) {
+        if (auto doc = ModrinthClient::parseJson(page.result())) index->addSearchHits(doc->object()["hits"].toArray());
+    }
+    return index->size() - before;
+}
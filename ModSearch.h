@@ -0,0 +1,45 @@
+#ifndef MODSEARCH_H
+#define MODSEARCH_H
+
+#include <functional>
+#include <optional>
+#include "ModrinthClient.h"
+#include "NameIndex.h"
+
+// Turns a free-form mod name into a Modrinth project: the local name index first, then full-text search
+// restricted to the loader and game version, then the cleaned name as a slug. Search results are fed back
+// into the index. Blocking; call from a worker thread.
+class ModSearch {
+public:
+    struct Result {
+        std::optional<ModInfo> mod;
+        QString status;
+        QString tag;
+    };
+
+    // One entry per target, in order; all entries that are set come from the same project.
+    struct TargetsResult {
+        QList<std::optional<ModInfo>> mods;
+        QString status;
+        QString tag;
+    };
+
+    explicit ModSearch(ModrinthClient* modrinth, NameIndex* index = nullptr);
+    Result find(const QString& name, const QString& loader, const QString& gameVersion);
+    TargetsResult findForTargets(const QString& name, const QList<PackTarget>& targets);
+    // Fills the index with the most downloaded mods by paging /search. Returns how many projects were added.
+    int buildIndexSnapshot(int projects);
+
+    static QString sanitizeModName(const QString& input);
+    static QString splitCamelCase(const QString& input);
+
+private:
+    // Offers each candidate project to accept in turn and stops at the first one it takes.
+    bool findProject(const QString& name, const QStringList& loaders, const QStringList& gameVersions,
+                     const std::function<bool(const QString&)>& accept, QString& status, QString& tag);
+
+    ModrinthClient* modrinth;
+    NameIndex* index;
+};
+
+#endif // MODSEARCH_H
@@ -0,0 +1,463 @@
+#include "ModrinthClient.h"
+#include "Tracer.h"
+
+#include <QPromise>
+#include <QSet>
+#include <QUrlQuery>
+#include <functional>
+#include <utility>
+
+const QString MODRINTH_API_BASE = "https://api.modrinth.com/v2";
+const int BULK_CHUNK_SIZE = 100;
+
+// Ids are short and a session sees at most a few hundred thousand distinct ones, so the pool is never trimmed.
+static QString internId(const QString& id) {
+    static QMutex mutex;
+    static QSet<QString> pool;
+    if (id.isEmpty()) return id;
+    QMutexLocker locker(&mutex);
+    auto it = pool.constFind(id);
+    if (it != pool.constEnd()) return *it;
+    pool.insert(id);
+    return id;
+}
+
+static Dependency::Kind dependencyKind(const QString& type) {
+    if (type == "optional") return Dependency::Kind::Optional;
+    if (type == "incompatible") return Dependency::Kind::Incompatible;
+    if (type == "embedded") return Dependency::Kind::Embedded;
+    return Dependency::Kind::Required;
+}
+
+// 0 for release, 1 for beta, 2 for alpha; -1 for versions that can't be installed at all.
+static int versionRank(const QJsonObject& version) {
+    if (version["files"].toArray().isEmpty()) return -1;
+    QString type = version["version_type"].toString();
+    if (type == "release") return 0;
+    if (type == "beta") return 1;
+    if (type == "alpha") return 2;
+    return -1;
+}
+
+// Calls visit with each object of a top-level JSON array, parsing one element at a time, until visit returns
+// false. Only element boundaries are found up front (tracking nesting and strings), which is far cheaper than
+// building the whole document. Returns false if the body is not a well-formed array.
+static bool forEachArrayObject(const QByteArray& body, const std::function<bool(const QJsonObject&)>& visit) {
+    const char* p = body.constData();
+    const qsizetype n = body.size();
+    qsizetype i = 0;
+    auto skipSpace = [&]() { while (i < n && (p[i] == ' ' || p[i] == '\n' || p[i] == '\r' || p[i] == '\t')) ++i; };
+    skipSpace();
+    if (i >= n || p[i] != '[') return false;
+    ++i;
+    skipSpace();
+    if (i < n && p[i] == ']') return true;
+    while (i < n) {
+        qsizetype start = i;
+        int depth = 0;
+        bool inString = false;
+        for (; i < n; ++i) {
+            char c = p[i];
+            if (inString) {
+                if (c == '\\') ++i;
+                else if (c == '"') inString = false;
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (depth == 0) break;
+                --depth;
+            } else if (c == ',' && depth == 0) {
+                break;
+            }
+        }
+        if (i >= n) return false;
+        QJsonDocument element = QJsonDocument::fromJson(QByteArray::fromRawData(p + start, i - start));
+        if (!element.isObject()) return false;
+        if (!visit(element.object())) return true;
+        if (p[i] == ']') return true;
+        ++i;
+        skipSpace();
+    }
+    return false;
+}
+
+ModrinthClient::ModrinthClient(HttpEngine* http, MetadataCache* cache) : http(http), cache(cache) {}
+
+static HttpResponse cancelledResponse() {
+    HttpResponse response;
+    response.error = QNetworkReply::OperationCanceledError;
+    response.errorString = "Cancelled";
+    return response;
+}
+
+QFuture<HttpResponse> ModrinthClient::request(const QUrl& url, QNetworkRequest::Priority priority) {
+    auto waiter = std::make_shared<Waiter<HttpResponse>>();
+    waiter->promise.start();
+    waiter->token = CancellationToken::current();
+    QFuture<HttpResponse> future = waiter->promise.future();
+    QString key = url.toString(QUrl::FullyEncoded);
+    std::optional<MetadataCache::Entry> cached = cache ? cache->lookup(key) : std::nullopt;
+    if (cached && cached->fresh) {
+        cache->recordHit();
+        HttpResponse response;
+        response.error = QNetworkReply::NoError;
+        response.statusCode = 200;
+        response.body = cached->body;
+        waiter->promise.addResult(response);
+        waiter->promise.finish();
+        return future;
+    }
+    join(key, url, priority, cached, waiter);
+    return future;
+}
+
+// The shared request runs under its own token, so no caller's cancellation or deadline reaches it until leave()
+// finds nobody else waiting; by then it is out of inFlight and later calls start afresh.
+void ModrinthClient::join(const QString& key, const QUrl& url, QNetworkRequest::Priority priority, const std::optional<MetadataCache::Entry>& cached,
+                          const std::shared_ptr<Waiter<HttpResponse>>& waiter) {
+    std::shared_ptr<SharedRequest> shared;
+    bool joined = false;
+    {
+        QMutexLocker locker(&inFlightMutex);
+        shared = inFlight.value(key);
+        joined = shared != nullptr;
+        if (!joined) {
+            shared = std::make_shared<SharedRequest>();
+            inFlight.insert(key, shared);
+        }
+        shared->waiters.append(waiter);
+    }
+    if (joined) coalesced.fetchAndAddRelaxed(1);
+    watch<HttpResponse>(waiter, [this, key, weakShared = std::weak_ptr<SharedRequest>(shared), weakWaiter = std::weak_ptr<Waiter<HttpResponse>>(waiter)]() {
+        auto shared = weakShared.lock();
+        auto waiter = weakWaiter.lock();
+        if (shared && waiter) leave(key, shared, waiter);
+    });
+    if (joined) return;
+    QNetworkRequest networkRequest(url);
+    networkRequest.setPriority(priority);
+    if (cached && !cached->etag.isEmpty()) networkRequest.setRawHeader("If-None-Match", cached->etag);
+    CancellationScope scope(shared->token);
+    http->get(networkRequest, nullptr, [this, shared, key, cached](const HttpResponse& reply) {
+        HttpResponse response = reply;
+        if (cache && cached && reply.statusCode == 304) {
+            cache->recordHit();
+            cache->store(key, cached->body, cached->etag);
+            response.error = QNetworkReply::NoError;
+            response.statusCode = 200;
+            response.body = cached->body;
+        } else if (cache && reply.ok()) {
+            cache->recordMiss();
+            cache->store(key, reply.body, reply.header("ETag"));
+        }
+        QList<std::shared_ptr<Waiter<HttpResponse>>> waiters;
+        {
+            QMutexLocker locker(&inFlightMutex);
+            if (inFlight.value(key) == shared) inFlight.remove(key);
+            waiters.swap(shared->waiters);
+            for (const auto& waiter : waiters) waiter->answered = true;
+        }
+        for (const auto& waiter : waiters) {
+            unwatch(waiter);
+            waiter->promise.addResult(response);
+            waiter->promise.finish();
+        }
+    });
+}
+
+void ModrinthClient::leave(const QString& key, const std::shared_ptr<SharedRequest>& shared, const std::shared_ptr<Waiter<HttpResponse>>& waiter) {
+    bool abandoned = false;
+    {
+        QMutexLocker locker(&inFlightMutex);
+        if (waiter->answered || !shared->waiters.removeOne(waiter)) return;
+        waiter->answered = true;
+        abandoned = shared->waiters.isEmpty();
+        if (abandoned && inFlight.value(key) == shared) inFlight.remove(key);
+    }
+    unwatch(waiter);
+    waiter->promise.addResult(cancelledResponse());
+    waiter->promise.finish();
+    if (abandoned) shared->token.cancel();
+}
+
+template <typename T>
+void ModrinthClient::watch(const std::shared_ptr<Waiter<T>>& waiter, const std::function<void()>& leave) {
+    if (!waiter->token.canBeCancelled()) return;
+    int subscription = waiter->token.subscribe(leave);
+    QDeadlineTimer deadline = waiter->token.deadline();
+    int deadlineCall = deadline.isForever() ? 0 : http->callAt(deadline, leave);
+    {
+        QMutexLocker locker(&inFlightMutex);
+        if (!waiter->answered) {
+            std::swap(waiter->subscription, subscription);
+            std::swap(waiter->deadlineCall, deadlineCall);
+        }
+    }
+    if (subscription) waiter->token.unsubscribe(subscription);
+    if (deadlineCall) http->cancelCall(deadlineCall);
+}
+
+// Once answered is set nothing else writes the ids, so they are read without the lock.
+template <typename T>
+void ModrinthClient::unwatch(const std::shared_ptr<Waiter<T>>& waiter) {
+    waiter->token.unsubscribe(waiter->subscription);
+    if (waiter->deadlineCall) http->cancelCall(waiter->deadlineCall);
+}
+
+std::optional<QJsonDocument> ModrinthClient::parseJson(const HttpResponse& reply) {
+    if (!reply.ok()) return std::nullopt;
+    TraceScope scope("parse", "parse JSON", reply.body.size());
+    QJsonDocument doc = QJsonDocument::fromJson(reply.body);
+    if (doc.isNull()) return std::nullopt;
+    return doc;
+}
+
+std::optional<QJsonDocument> ModrinthClient::getJson(const QUrl& url, QNetworkRequest::Priority priority) {
+    return parseJson(request(url, priority).result());
+}
+
+QUrl ModrinthClient::versionListUrl(const QString& projectIdOrSlug, const QStringList& loaders, const QStringList& gameVersions) const {
+    QUrlQuery query;
+    query.addQueryItem("loaders", QJsonDocument(QJsonArray::fromStringList(loaders)).toJson(QJsonDocument::Compact));
+    query.addQueryItem("game_versions", QJsonDocument(QJsonArray::fromStringList(gameVersions)).toJson(QJsonDocument::Compact));
+    QUrl url(baseUrl + "/project/" + projectIdOrSlug + "/version");
+    url.setQuery(query);
+    return url;
+}
+
+QJsonObject ModrinthClient::pickVersion(const HttpResponse& versionList) {
+    QJsonObject best;
+    if (!versionList.ok()) return best;
+    TraceScope scope("parse", "pick version", versionList.body.size());
+    int bestRank = -1;
+    forEachArrayObject(versionList.body, [&](const QJsonObject& version) {
+        int rank = versionRank(version);
+        if (rank >= 0 && (bestRank < 0 || rank < bestRank)) {
+            best = version;
+            bestRank = rank;
+        }
+        return bestRank != 0;
+    });
+    return best;
+}
+
+QList<QJsonObject> ModrinthClient::pickVersions(const HttpResponse& versionList, const QList<PackTarget>& targets) {
+    QList<QJsonObject> best(targets.size());
+    if (!versionList.ok()) return best;
+    TraceScope scope("parse", "pick versions", versionList.body.size());
+    QList<int> bestRank(targets.size(), -1);
+    int settled = 0;
+    forEachArrayObject(versionList.body, [&](const QJsonObject& version) {
+        int rank = versionRank(version);
+        if (rank < 0) return true;
+        QJsonArray loaders = version["loaders"].toArray();
+        QJsonArray gameVersions = version["game_versions"].toArray();
+        for (int i = 0; i < targets.size(); ++i) {
+            if (bestRank[i] >= 0 && rank >= bestRank[i]) continue;
+            if (!loaders.contains(targets[i].loader) || !gameVersions.contains(targets[i].gameVersion)) continue;
+            if (rank == 0) ++settled;
+            best[i] = version;
+            bestRank[i] = rank;
+        }
+        return settled < targets.size();
+    });
+    return best;
+}
+
+ModInfo ModrinthClient::makeModInfo(const QJsonObject& project, const QJsonObject& version) {
+    QJsonArray files = version["files"].toArray();
+    QJsonObject fileObj = files[0].toObject();
+    for (const auto& f : files) {
+        if (f.toObject()["primary"].toBool()) { fileObj = f.toObject(); break; }
+    }
+    ModInfo info;
+    info.name = project["title"].toString();
+    info.projectId = internId(project["id"].toString());
+    info.versionId = internId(version["id"].toString());
+    info.downloadUrl = fileObj["url"].toString();
+    info.filename = fileObj["filename"].toString();
+    info.size = fileObj["size"].toInteger();
+    info.sha1 = fileObj["hashes"].toObject()["sha1"].toString();
+    info.sha512 = fileObj["hashes"].toObject()["sha512"].toString();
+    QJsonArray dependencies = version["dependencies"].toArray();
+    info.dependencies.reserve(dependencies.size());
+    for (const auto& depVal : dependencies) {
+        QJsonObject depObj = depVal.toObject();
+        info.dependencies.append({internId(depObj["project_id"].toString()), internId(depObj["version_id"].toString()),
+                                  dependencyKind(depObj["dependency_type"].toString())});
+    }
+    return info;
+}
+
+// The first call does the work under its own token; overlapping calls wait for its result. If that token cuts the
+// work short, callers whose own tokens are still live run the lookup again rather than share the cancellation.
+std::optional<ModInfo> ModrinthClient::getModInfo(const QString& projectIdOrSlug, const QString& loader, const QString& gameVersion) {
+    QString key = projectIdOrSlug + '|' + loader + '|' + gameVersion;
+    CancellationToken token = CancellationToken::current();
+    std::shared_ptr<Waiter<SharedModInfo>> waiter;
+    {
+        QMutexLocker locker(&inFlightMutex);
+        auto it = modInfoInFlight.find(key);
+        if (it != modInfoInFlight.end()) {
+            waiter = std::make_shared<Waiter<SharedModInfo>>();
+            waiter->promise.start();
+            waiter->token = token;
+            it->append(waiter);
+        } else {
+            modInfoInFlight.insert(key, {});
+        }
+    }
+    if (waiter) {
+        coalesced.fetchAndAddRelaxed(1);
+        QFuture<SharedModInfo> future = waiter->promise.future();
+        watch<SharedModInfo>(waiter, [this, key, weakWaiter = std::weak_ptr<Waiter<SharedModInfo>>(waiter)]() {
+            auto waiter = weakWaiter.lock();
+            if (!waiter) return;
+            {
+                QMutexLocker locker(&inFlightMutex);
+                auto it = modInfoInFlight.find(key);
+                if (waiter->answered || it == modInfoInFlight.end() || !it->removeOne(waiter)) return;
+                waiter->answered = true;
+            }
+            unwatch(waiter);
+            waiter->promise.addResult(SharedModInfo());
+            waiter->promise.finish();
+        });
+        SharedModInfo shared = future.result();
+        if (shared.retry && !token.isCancelled()) return getModInfo(projectIdOrSlug, loader, gameVersion);
+        return shared.info;
+    }
+    std::optional<ModInfo> info = fetchModInfo(projectIdOrSlug, loader, gameVersion);
+    QList<std::shared_ptr<Waiter<SharedModInfo>>> waiters;
+    {
+        QMutexLocker locker(&inFlightMutex);
+        waiters = modInfoInFlight.take(key);
+        for (const auto& joined : waiters) joined->answered = true;
+    }
+    SharedModInfo shared{info, token.isCancelled()};
+    for (const auto& joined : waiters) {
+        unwatch(joined);
+        joined->promise.addResult(shared);
+        joined->promise.finish();
+    }
+    return info;
+}
+
+std::optional<ModInfo> ModrinthClient::fetchModInfo(const QString& projectIdOrSlug, const QString& loader, const QString& gameVersion) {
+    auto projDoc = getJson(QUrl(baseUrl + "/project/" + projectIdOrSlug));
+    if (!projDoc || !projDoc->isObject()) return std::nullopt;
+    QJsonObject projObj = projDoc->object();
+    if (projObj.isEmpty()) return std::nullopt;
+    QJsonObject verObj = pickVersion(request(versionListUrl(projObj.value("slug").toString(), {loader}, {gameVersion})).result());
+    if (verObj.isEmpty()) return std::nullopt;
+    return makeModInfo(projObj, verObj);
+}
+
+QList<std::optional<ModInfo>> ModrinthClient::getModInfoForTargets(const QString& projectIdOrSlug, const QList<PackTarget>& targets) {
+    QList<std::optional<ModInfo>> infos(targets.size());
+    auto projDoc = getJson(QUrl(baseUrl + "/project/" + projectIdOrSlug));
+    if (!projDoc || !projDoc->isObject() || projDoc->object().isEmpty()) return infos;
+    QJsonObject projObj = projDoc->object();
+    QStringList loaders, gameVersions;
+    for (const auto& target : targets) {
+        if (!loaders.contains(target.loader)) loaders.append(target.loader);
+        if (!gameVersions.contains(target.gameVersion)) gameVersions.append(target.gameVersion);
+    }
+    QList<QJsonObject> versions = pickVersions(request(versionListUrl(projObj.value("slug").toString(), loaders, gameVersions)).result(), targets);
+    for (int i = 0; i < targets.size(); ++i) {
+        if (!versions[i].isEmpty()) infos[i] = makeModInfo(projObj, versions[i]);
+    }
+    return infos;
+}
+
+QHash<QString, QJsonObject> ModrinthClient::getBulk(const QString& endpoint, const QStringList& ids, QNetworkRequest::Priority priority) {
+    QList<QFuture<HttpResponse>> chunks;
+    for (int i = 0; i < ids.size(); i += BULK_CHUNK_SIZE) {
+        QUrlQuery query;
+        query.addQueryItem("ids", QJsonDocument(QJsonArray::fromStringList(ids.mid(i, BULK_CHUNK_SIZE))).toJson(QJsonDocument::Compact));
+        QUrl url(baseUrl + endpoint);
+        url.setQuery(query);
+        chunks.append(request(url, priority));
+    }
+    QHash<QString, QJsonObject> objects;
+    for (auto& chunk : chunks) {
+        if (auto doc = parseJson(chunk.result())) {
+            for (const auto& v : doc->array()) {
+                QJsonObject obj = v.toObject();
+                objects.insert(obj["id"].toString(), obj);
+            }
+        }
+    }
+    return objects;
+}
+
+QHash<QString, QJsonObject> ModrinthClient::getProjects(const QStringList& projectIds, QNetworkRequest::Priority priority) {
+    return getBulk("/projects", projectIds, priority);
+}
+
+QHash<QString, QString> ModrinthClient::getProjectTitles(const QStringList& projectIds) {
+    QHash<QString, QString> titles;
+    for (const auto& project : getProjects(projectIds)) {
+        titles.insert(project["id"].toString(), project["title"].toString());
+    }
+    return titles;
+}
+
+QHash<QString, QJsonObject> ModrinthClient::postForVersions(const QString& endpoint, const QJsonObject& body) {
+    QHash<QString, QJsonObject> versions;
+    auto doc = parseJson(http->post(QNetworkRequest(QUrl(baseUrl + endpoint)), QJsonDocument(body).toJson(QJsonDocument::Compact)).result());
+    if (!doc || !doc->isObject()) return versions;
+    QJsonObject byHash = doc->object();
+    for (auto it = byHash.constBegin(); it != byHash.constEnd(); ++it) versions.insert(it.key(), it.value().toObject());
+    return versions;
+}
+
+QHash<QString, QJsonObject> ModrinthClient::getVersionsByHash(const QStringList& hashes, const QString& algorithm) {
+    if (hashes.isEmpty()) return {};
+    return postForVersions("/version_files", QJsonObject{{"hashes", QJsonArray::fromStringList(hashes)}, {"algorithm", algorithm}});
+}
+
+QHash<QString, QJsonObject> ModrinthClient::getLatestVersionsByHash(const QStringList& hashes, const QString& algorithm, const QString& loader, const QString& gameVersion) {
+    if (hashes.isEmpty()) return {};
+    QJsonObject body{{"hashes", QJsonArray::fromStringList(hashes)}, {"algorithm", algorithm}, {"loaders", QJsonArray({loader})}, {"game_versions", QJsonArray({gameVersion})}};
+    return postForVersions("/version_files/update", body);
+}
+
+QHash<QString, ModInfo> ModrinthClient::getModInfos(const QList<ModRef>& refs, const QString& loader, const QString& gameVersion) {
+    QHash<QString, ModInfo> resolved;
+    QStringList versionIds;
+    for (const auto& ref : refs) {
+        if (!ref.versionId.isEmpty() && !versionIds.contains(ref.versionId)) versionIds.append(ref.versionId);
+    }
+    // A pinned version is only usable if it was built for the requested loader and game version.
+    QHash<QString, QJsonObject> versions = getBulk("/versions", versionIds);
+    QHash<QString, QJsonObject> pinned;
+    for (const auto& verObj : versions) {
+        bool compatible = verObj["loaders"].toArray().contains(loader) && verObj["game_versions"].toArray().contains(gameVersion);
+        if (compatible && !verObj["files"].toArray().isEmpty()) pinned.insert(verObj["project_id"].toString(), verObj);
+    }
+    QStringList projectIds;
+    for (const auto& ref : refs) {
+        QString id = ref.projectId.isEmpty() ? versions.value(ref.versionId).value("project_id").toString() : ref.projectId;
+        if (!id.isEmpty() && !projectIds.contains(id)) projectIds.append(id);
+    }
+    // Issue every per-project fallback up front so they overlap on the wire, then collect.
+    QHash<QString, QFuture<HttpResponse>> fallbacks;
+    for (const QString& id : projectIds) {
+        if (!pinned.contains(id)) fallbacks.insert(id, request(versionListUrl(id, {loader}, {gameVersion})));
+    }
+    QHash<QString, QJsonObject> projects = getBulk("/projects", projectIds);
+    for (const QString& id : projectIds) {
+        QJsonObject verObj = pinned.value(id);
+        if (verObj.isEmpty()) verObj = pickVersion(fallbacks[id].result());
+        if (verObj.isEmpty() || !projects.contains(id)) continue;
+        resolved.insert(id, makeModInfo(projects[id], verObj));
+    }
+    for (const auto& ref : refs) {
+        QString id = versions.value(ref.versionId).value("project_id").toString();
+        if (ref.projectId.isEmpty() && resolved.contains(id)) resolved.insert(ref.versionId, resolved.value(id));
+    }
+    return resolved;
+}
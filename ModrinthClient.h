@@ -0,0 +1,161 @@
+#ifndef MODRINTHCLIENT_H
+#define MODRINTHCLIENT_H
+
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QHash>
+#include <QMutex>
+#include <QPromise>
+#include <QUrl>
+#include <functional>
+#include <memory>
+#include <optional>
+#include "HttpEngine.h"
+#include "MetadataCache.h"
+
+extern const QString MODRINTH_API_BASE;
+
+// One entry of a version's dependency list. Either id may be empty, but not both.
+struct Dependency {
+    enum class Kind : quint8 { Required, Optional, Incompatible, Embedded };
+    QString projectId;
+    QString versionId;
+    Kind kind = Kind::Required;
+};
+
+// Every string here is an implicitly shared Qt string and ids are interned (see makeModInfo), so copies
+// handed through queued signals and worker lambdas share one immutable buffer per field rather than
+// duplicating it.
+struct ModInfo {
+    QString originalQuery;
+    QString name;
+    QString projectId;
+    QString versionId;
+    QString downloadUrl;
+    QString filename;
+    qint64 size = 0;
+    QString sha1;
+    QString sha512;
+    QList<Dependency> dependencies;
+    bool isDependency = false;
+    bool updateAvailable = false;
+};
+Q_DECLARE_METATYPE(ModInfo);
+
+// One loader and game version a pack is built for.
+struct PackTarget {
+    QString loader;
+    QString gameVersion;
+    // "fabric-1.20.1": used for folder names and report keys.
+    QString label() const { return loader + '-' + gameVersion; }
+    bool operator==(const PackTarget& other) const { return loader == other.loader && gameVersion == other.gameVersion; }
+};
+
+// A project to resolve, optionally pinned to a version (as carried by dependency objects).
+struct ModRef {
+    QString projectId;
+    QString versionId;
+};
+
+// Identical calls that overlap in time are coalesced: concurrent requests for the same URL share one
+// reply, and concurrent getModInfo calls for the same project, loader and version share one result.
+// Each caller still answers to its own CancellationToken: one that is cancelled or runs out of time gets a
+// cancelled result without disturbing the others, and a shared request is only aborted once nobody is left
+// waiting for it.
+class ModrinthClient {
+public:
+    ModrinthClient(HttpEngine* http, MetadataCache* cache = nullptr);
+
+    // Defaults to MODRINTH_API_BASE; pointing it at a local stand-in makes runs reproducible offline.
+    // Set before issuing requests.
+    void setApiBase(const QString& base) { baseUrl = base; }
+    const QString& apiBase() const { return baseUrl; }
+
+    // Served from the metadata cache when fresh; otherwise queued on the engine at the given priority.
+    // Stale entries are revalidated with If-None-Match.
+    QFuture<HttpResponse> request(const QUrl& url, QNetworkRequest::Priority priority = QNetworkRequest::NormalPriority);
+    std::optional<QJsonDocument> getJson(const QUrl& url, QNetworkRequest::Priority priority = QNetworkRequest::NormalPriority);
+    std::optional<ModInfo> getModInfo(const QString& projectIdOrSlug, const QString& loader, const QString& gameVersion);
+    // The same lookup for several targets at once: the project and one version list covering every target are
+    // fetched once and filtered locally. One entry per target, in order.
+    QList<std::optional<ModInfo>> getModInfoForTargets(const QString& projectIdOrSlug, const QList<PackTarget>& targets);
+    // Resolves many projects at once through the bulk /projects and /versions endpoints, falling back
+    // to a per-project version query only for refs without a usable pinned version. Keyed by project id;
+    // refs that only carry a version id are additionally keyed by that version id.
+    QHash<QString, ModInfo> getModInfos(const QList<ModRef>& refs, const QString& loader, const QString& gameVersion);
+
+    // Project documents through the bulk /projects endpoint, keyed by project id.
+    QHash<QString, QJsonObject> getProjects(const QStringList& projectIds, QNetworkRequest::Priority priority = QNetworkRequest::NormalPriority);
+    QHash<QString, QString> getProjectTitles(const QStringList& projectIds);
+
+    // Calls that were answered by joining one already in flight instead of going to the network.
+    qint64 coalescedCount() const { return coalesced.loadRelaxed(); }
+
+    // Identifies installed files in one POST /version_files call. Keyed by the hash that was sent.
+    QHash<QString, QJsonObject> getVersionsByHash(const QStringList& hashes, const QString& algorithm);
+    // POST /version_files/update: the newest version for the loader and game version of each file's project.
+    QHash<QString, QJsonObject> getLatestVersionsByHash(const QStringList& hashes, const QString& algorithm, const QString& loader, const QString& gameVersion);
+
+    static std::optional<QJsonDocument> parseJson(const HttpResponse& reply);
+    // Picks from a /version list response: the newest release with files, else the newest beta, else the
+    // newest alpha. The list is newest first and parsed one version at a time, so
+    // the usual case stops after the first element instead of building a document for the whole array.
+    static QJsonObject pickVersion(const HttpResponse& versionList);
+    // The same choice made separately for each target, from one list covering all of them. Stops as soon as
+    // every target has a release.
+    static QList<QJsonObject> pickVersions(const HttpResponse& versionList, const QList<PackTarget>& targets);
+    // Project and version ids are interned: each distinct id is stored once however many mods and
+    // dependency edges refer to it.
+    static ModInfo makeModInfo(const QJsonObject& project, const QJsonObject& version);
+
+private:
+    // One caller of a coalesced call, answered exactly once: by the call, or early by its own token.
+    template <typename T>
+    struct Waiter {
+        QPromise<T> promise;
+        CancellationToken token;
+        int subscription = 0;
+        // HttpEngine::callAt id of the deadline check, stopped once the waiter is answered.
+        int deadlineCall = 0;
+        bool answered = false;
+    };
+    // A network request shared by every overlapping request() for one URL. Its token belongs to none of
+    // the callers and is cancelled when the last of them gives up.
+    struct SharedRequest {
+        CancellationToken token = CancellationToken::create();
+        QList<std::shared_ptr<Waiter<HttpResponse>>> waiters;
+    };
+    // What a getModInfo call hands the calls that joined it. retry is set when the call was cut short by its
+    // own caller's token, which says nothing about theirs.
+    struct SharedModInfo {
+        std::optional<ModInfo> info;
+        bool retry = false;
+    };
+
+    void join(const QString& key, const QUrl& url, QNetworkRequest::Priority priority, const std::optional<MetadataCache::Entry>& cached,
+              const std::shared_ptr<Waiter<HttpResponse>>& waiter);
+    void leave(const QString& key, const std::shared_ptr<SharedRequest>& shared, const std::shared_ptr<Waiter<HttpResponse>>& waiter);
+    // Calls leave once the waiter's token is cancelled or its deadline passes. leave should hold the waiter
+    // weakly, so an answered waiter and its result are not kept alive until the deadline.
+    template <typename T>
+    void watch(const std::shared_ptr<Waiter<T>>& waiter, const std::function<void()>& leave);
+    // Undoes watch() for a waiter that has just been answered.
+    template <typename T>
+    void unwatch(const std::shared_ptr<Waiter<T>>& waiter);
+    std::optional<ModInfo> fetchModInfo(const QString& projectIdOrSlug, const QString& loader, const QString& gameVersion);
+    QHash<QString, QJsonObject> postForVersions(const QString& endpoint, const QJsonObject& body);
+    QHash<QString, QJsonObject> getBulk(const QString& endpoint, const QStringList& ids, QNetworkRequest::Priority priority = QNetworkRequest::NormalPriority);
+    QUrl versionListUrl(const QString& projectIdOrSlug, const QStringList& loaders, const QStringList& gameVersions) const;
+
+    HttpEngine* http;
+    MetadataCache* cache;
+    QString baseUrl = MODRINTH_API_BASE;
+    QMutex inFlightMutex;
+    QHash<QString, std::shared_ptr<SharedRequest>> inFlight;
+    // Keyed like getModInfo's calls; the list holds the calls waiting on the one doing the work.
+    QHash<QString, QList<std::shared_ptr<Waiter<SharedModInfo>>>> modInfoInFlight;
+    QAtomicInteger<qint64> coalesced;
+};
+
+#endif // MODRINTHCLIENT_H
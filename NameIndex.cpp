@@ -0,0 +1,163 @@
+#include "NameIndex.h"
+
+#include <QDataStream>
+#include <QJsonObject>
+#include <QFile>
+#include <QSaveFile>
+#include <algorithm>
+
+const quint32 INDEX_MAGIC = 0x4350494E; // "CPIN"
+const quint32 INDEX_FORMAT = 1;
+// High enough that "sodium extra" does not rank "sodium" first; hints only reorder /search hits anyway.
+const double MIN_SIMILARITY = 0.7;
+
+QString NameIndex::normalize(const QString& name) {
+    QString key;
+    key.reserve(name.size());
+    for (QChar c : name) {
+        if (c.isLetterOrNumber()) key.append(c.toLower());
+    }
+    return key;
+}
+
+QList<quint64> NameIndex::trigramsOf(const QString& key) {
+    // Padding lets one- and two-letter keys still produce trigrams, and weights the start and end of names.
+    QString padded = "  " + key + " ";
+    QList<quint64> grams;
+    for (int i = 0; i + 3 <= padded.size(); ++i) {
+        quint64 gram = quint64(padded[i].unicode()) << 32 | quint64(padded[i + 1].unicode()) << 16 | padded[i + 2].unicode();
+        if (!grams.contains(gram)) grams.append(gram);
+    }
+    return grams;
+}
+
+void NameIndex::indexKey(const QString& key, int entry, bool acronym) {
+    if (key.isEmpty()) return;
+    QList<int>& owners = acronym ? acronyms[key] : exact[key];
+    if (owners.contains(entry)) return;
+    owners.append(entry);
+    int keyIndex = keys.size();
+    QList<quint64> grams = trigramsOf(key);
+    keys.append({entry, int(grams.size())});
+    for (quint64 gram : grams) postings[gram].append(keyIndex);
+}
+
+void NameIndex::add(const Entry& entry) {
+    QWriteLocker locker(&lock);
+    int index = byProjectId.value(entry.projectId, -1);
+    if (index < 0) {
+        index = entries.size();
+        entries.append(entry);
+        byProjectId.insert(entry.projectId, index);
+    } else {
+        Entry& existing = entries[index];
+        existing.slug = entry.slug;
+        existing.title = entry.title;
+        existing.downloads = qMax(existing.downloads, entry.downloads);
+        for (const auto& alias : entry.aliases) {
+            if (!existing.aliases.contains(alias)) existing.aliases.append(alias);
+        }
+    }
+    const Entry& stored = entries[index];
+    indexKey(normalize(stored.slug), index);
+    indexKey(normalize(stored.title), index);
+    QString acronym;
+    for (const QString& word : stored.title.split(' ', Qt::SkipEmptyParts)) {
+        if (word[0].isLetterOrNumber()) acronym.append(word[0].toLower());
+    }
+    if (acronym.size() >= 2) indexKey(acronym, index, true);
+    for (const auto& alias : stored.aliases) indexKey(normalize(alias), index);
+}
+
+void NameIndex::addSearchHits(const QJsonArray& hits) {
+    for (const auto& hitVal : hits) {
+        QJsonObject hit = hitVal.toObject();
+        Entry entry;
+        entry.projectId = hit["project_id"].toString();
+        entry.slug = hit["slug"].toString();
+        entry.title = hit["title"].toString();
+        entry.downloads = hit["downloads"].toInteger();
+        if (!entry.projectId.isEmpty()) add(entry);
+    }
+}
+
+void NameIndex::addAlias(const QString& alias, const QString& projectId) {
+    QWriteLocker locker(&lock);
+    int index = byProjectId.value(projectId, -1);
+    if (index < 0 || entries[index].aliases.contains(alias)) return;
+    entries[index].aliases.append(alias);
+    indexKey(normalize(alias), index);
+}
+
+QStringList NameIndex::lookup(const QString& name, int limit) const {
+    QString key = normalize(name);
+    QStringList found;
+    if (key.isEmpty()) return found;
+    QReadLocker locker(&lock);
+    QList<int> owners = exact.value(key);
+    std::sort(owners.begin(), owners.end(), [this](int a, int b) { return entries[a].downloads > entries[b].downloads; });
+    for (int i = 0; i < owners.size() && found.size() < limit; ++i) found.append(entries[owners[i]].projectId);
+    return found;
+}
+
+QStringList NameIndex::suggest(const QString& name, int limit) const {
+    QString key = normalize(name);
+    QStringList found;
+    if (key.isEmpty()) return found;
+    QReadLocker locker(&lock);
+    // An acronym match scores above any trigram match, so "jei" puts Just Enough Items before "jeil".
+    QHash<int, double> best;
+    for (int entry : acronyms.value(key)) best.insert(entry, 2.0);
+    QList<quint64> grams = trigramsOf(key);
+    QHash<int, int> shared;
+    for (quint64 gram : grams) {
+        for (int keyIndex : postings.value(gram)) shared[keyIndex]++;
+    }
+    // Dice coefficient over trigram sets; keep each project's best-scoring key.
+    for (auto it = shared.constBegin(); it != shared.constEnd(); ++it) {
+        const Key& candidate = keys[it.key()];
+        double score = 2.0 * it.value() / (grams.size() + candidate.trigrams);
+        if (score >= MIN_SIMILARITY && score > best.value(candidate.entry)) best.insert(candidate.entry, score);
+    }
+    QList<int> ranked = best.keys();
+    std::sort(ranked.begin(), ranked.end(), [this, &best](int a, int b) {
+        if (!qFuzzyCompare(best[a], best[b])) return best[a] > best[b];
+        return entries[a].downloads > entries[b].downloads;
+    });
+    for (int i = 0; i < ranked.size() && found.size() < limit; ++i) found.append(entries[ranked[i]].projectId);
+    return found;
+}
+
+int NameIndex::size() const {
+    QReadLocker locker(&lock);
+    return entries.size();
+}
+
+bool NameIndex::load(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    QDataStream in(&file);
+    quint32 magic = 0, format = 0;
+    in >> magic >> format;
+    if (magic != INDEX_MAGIC || format != INDEX_FORMAT) return false;
+    qint32 count = 0;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Entry entry;
+        in >> entry.projectId >> entry.slug >> entry.title >> entry.downloads >> entry.aliases;
+        if (in.status() == QDataStream::Ok) add(entry);
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+bool NameIndex::save(const QString& path) const {
+    QReadLocker locker(&lock);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    QDataStream out(&file);
+    out << INDEX_MAGIC << INDEX_FORMAT << qint32(entries.size());
+    for (const auto& entry : entries) {
+        out << entry.projectId << entry.slug << entry.title << entry.downloads << entry.aliases;
+    }
+    return file.commit();
+}
@@ -0,0 +1,59 @@
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include <QHash>
+#include <QJsonArray>
+#include <QList>
+#include <QReadWriteLock>
+#include <QString>
+#include <QStringList>
+
+// Maps informal mod names to Modrinth project ids without a network round trip. Slugs, titles, title
+// acronyms ("jei") and aliases are normalized to lowercase alphanumerics. Only a slug, title or alias that
+// matches exactly is trusted on its own; acronyms and trigram-similar keys are hints, ranked by similarity
+// and then by download count, for ordering what /search returns. Learns from every search result it is
+// shown and persists between runs. Safe to use from several threads.
+class NameIndex {
+public:
+    struct Entry {
+        QString projectId;
+        QString slug;
+        QString title;
+        qint64 downloads = 0;
+        QStringList aliases;
+    };
+
+    void add(const Entry& entry);
+    // Accepts the "hits" array of a /search response.
+    void addSearchHits(const QJsonArray& hits);
+    void addAlias(const QString& alias, const QString& projectId);
+
+    // Projects whose slug, title or alias is exactly name, most downloaded first.
+    QStringList lookup(const QString& name, int limit = 3) const;
+    // Projects name might mean, by acronym or trigram similarity, best first. Never confirmed on their own.
+    QStringList suggest(const QString& name, int limit = 5) const;
+    int size() const;
+
+    bool load(const QString& path);
+    bool save(const QString& path) const;
+
+    static QString normalize(const QString& name);
+
+private:
+    struct Key {
+        int entry;
+        int trigrams;
+    };
+    void indexKey(const QString& key, int entry, bool acronym = false);
+    static QList<quint64> trigramsOf(const QString& key);
+
+    mutable QReadWriteLock lock;
+    QList<Entry> entries;
+    QHash<QString, int> byProjectId;
+    QHash<QString, QList<int>> exact;
+    QHash<QString, QList<int>> acronyms;
+    QList<Key> keys;
+    QHash<quint64, QList<int>> postings;
+};
+
+#endif // NAMEINDEX_H
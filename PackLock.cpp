@@ -0,0 +1,153 @@
+#include "PackLock.h"
+#include "Zip.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSaveFile>
+
+const int LOCK_FORMAT = 1;
+const QString MRPACK_INDEX = "modrinth.index.json";
+
+// A lock or pack names the file a download is saved as, so the name must stay inside the target folder: no
+// directories, no "..", nothing a platform would read as absolute.
+static bool isSafeFilename(const QString& filename) {
+    if (filename.isEmpty() || filename.contains("..") || filename.contains('/') || filename.contains('\\') || filename.contains(':')) return false;
+    return !QDir::isAbsolutePath(filename);
+}
+
+// Modrinth's dependency keys for each loader in modrinth.index.json.
+static QString mrpackLoaderKey(const QString& loader) {
+    if (loader == "fabric") return "fabric-loader";
+    if (loader == "quilt") return "quilt-loader";
+    return loader;
+}
+
+QJsonObject PackLock::toJson() const {
+    QJsonArray entries;
+    for (const auto& mod : mods) {
+        entries.append(QJsonObject{
+            {"name", mod.name},
+            {"projectId", mod.projectId},
+            {"versionId", mod.versionId},
+            {"filename", mod.filename},
+            {"url", mod.downloadUrl},
+            {"size", mod.size},
+            {"sha1", mod.sha1},
+            {"sha512", mod.sha512},
+            {"dependency", mod.isDependency},
+        });
+    }
+    return QJsonObject{
+        {"formatVersion", LOCK_FORMAT},
+        {"name", name},
+        {"gameVersion", gameVersion},
+        {"loader", loader},
+        {"loaderVersion", loaderVersion},
+        {"mods", entries},
+    };
+}
+
+std::optional<PackLock> PackLock::fromJson(const QJsonObject& json) {
+    if (json["formatVersion"].toInt() != LOCK_FORMAT) return std::nullopt;
+    PackLock lock;
+    lock.name = json["name"].toString();
+    lock.gameVersion = json["gameVersion"].toString();
+    lock.loader = json["loader"].toString();
+    lock.loaderVersion = json["loaderVersion"].toString();
+    for (const auto& v : json["mods"].toArray()) {
+        QJsonObject entry = v.toObject();
+        ModInfo mod;
+        mod.name = entry["name"].toString();
+        mod.projectId = entry["projectId"].toString();
+        mod.versionId = entry["versionId"].toString();
+        mod.filename = entry["filename"].toString();
+        mod.downloadUrl = entry["url"].toString();
+        mod.size = entry["size"].toInteger();
+        mod.sha1 = entry["sha1"].toString();
+        mod.sha512 = entry["sha512"].toString();
+        mod.isDependency = entry["dependency"].toBool();
+        if (!isSafeFilename(mod.filename) || mod.downloadUrl.isEmpty()) return std::nullopt;
+        lock.mods.append(mod);
+    }
+    return lock;
+}
+
+bool PackLock::save(const QString& path) const {
+    if (path.endsWith(".mrpack", Qt::CaseInsensitive)) return exportMrpack(path);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Indented));
+    return file.commit();
+}
+
+std::optional<PackLock> PackLock::load(const QString& path) {
+    if (path.endsWith(".mrpack", Qt::CaseInsensitive)) return importMrpack(path);
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return std::nullopt;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject()) return std::nullopt;
+    return fromJson(doc.object());
+}
+
+bool PackLock::exportMrpack(const QString& path) const {
+    QJsonArray files;
+    for (const auto& mod : mods) {
+        files.append(QJsonObject{
+            {"path", "mods/" + mod.filename},
+            {"hashes", QJsonObject{{"sha1", mod.sha1}, {"sha512", mod.sha512}}},
+            {"downloads", QJsonArray({mod.downloadUrl})},
+            {"fileSize", mod.size},
+        });
+    }
+    QJsonObject dependencies{{"minecraft", gameVersion}};
+    if (!loaderVersion.isEmpty()) dependencies.insert(mrpackLoaderKey(loader), loaderVersion);
+    QJsonObject index{
+        {"formatVersion", 1},
+        {"game", "minecraft"},
+        {"versionId", "1.0.0"},
+        {"name", name.isEmpty() ? QFileInfo(path).completeBaseName() : name},
+        {"files", files},
+        {"dependencies", dependencies},
+    };
+    return writeZip(path, {{MRPACK_INDEX, QJsonDocument(index).toJson(QJsonDocument::Indented)}});
+}
+
+std::optional<PackLock> PackLock::importMrpack(const QString& path) {
+    std::optional<QByteArray> data = readZipEntry(path, MRPACK_INDEX);
+    if (!data) return std::nullopt;
+    QJsonObject index = QJsonDocument::fromJson(*data).object();
+    if (index["game"].toString() != "minecraft") return std::nullopt;
+    PackLock lock;
+    lock.name = index["name"].toString();
+    QJsonObject dependencies = index["dependencies"].toObject();
+    lock.gameVersion = dependencies["minecraft"].toString();
+    for (const QString& loader : {"fabric", "quilt", "forge", "neoforge"}) {
+        if (dependencies.contains(mrpackLoaderKey(loader))) {
+            lock.loader = loader;
+            lock.loaderVersion = dependencies[mrpackLoaderKey(loader)].toString();
+        }
+    }
+    // Modrinth CDN URLs carry the project and version ids: /data/<project>/versions/<version>/<file>.
+    static const QRegularExpression cdnPath(R"(/data/([^/]+)/versions/([^/]+)/)");
+    for (const auto& v : index["files"].toArray()) {
+        QJsonObject entry = v.toObject();
+        QString filePath = entry["path"].toString();
+        QJsonArray downloads = entry["downloads"].toArray();
+        if (!filePath.startsWith("mods/") || !isSafeFilename(filePath.mid(5)) || downloads.isEmpty()) continue;
+        ModInfo mod;
+        mod.filename = filePath.mid(5);
+        mod.name = QFileInfo(mod.filename).completeBaseName();
+        mod.downloadUrl = downloads[0].toString();
+        mod.size = entry["fileSize"].toInteger();
+        mod.sha1 = entry["hashes"].toObject()["sha1"].toString();
+        mod.sha512 = entry["hashes"].toObject()["sha512"].toString();
+        QRegularExpressionMatch match = cdnPath.match(mod.downloadUrl);
+        if (match.hasMatch()) {
+            mod.projectId = match.captured(1);
+            mod.versionId = match.captured(2);
+        }
+        lock.mods.append(mod);
+    }
+    return lock;
+}
@@ -0,0 +1,28 @@
+#ifndef PACKLOCK_H
+#define PACKLOCK_H
+
+#include <optional>
+#include "ModrinthClient.h"
+
+// A fully resolved pack: every file of the dependency closure pinned to an exact version, URL, size and
+// hash. Installing from one needs no search or resolution, only the downloads themselves.
+struct PackLock {
+    QString name;
+    QString gameVersion;
+    QString loader;
+    QString loaderVersion;
+    QList<ModInfo> mods;
+
+    QJsonObject toJson() const;
+    static std::optional<PackLock> fromJson(const QJsonObject& json);
+
+    // Chooses the format by extension: .mrpack for Modrinth modpacks, the JSON lockfile otherwise.
+    bool save(const QString& path) const;
+    static std::optional<PackLock> load(const QString& path);
+
+    bool exportMrpack(const QString& path) const;
+    // Only files under mods/ are taken; overrides and other folders in the pack are left out.
+    static std::optional<PackLock> importMrpack(const QString& path);
+};
+
+#endif // PACKLOCK_H
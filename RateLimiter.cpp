@@ -0,0 +1,58 @@
+#include "RateLimiter.h"
+
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cmath>
+
+using namespace std::chrono;
+
+RateLimiter::RateLimiter(int calls_per_minute, int burst)
+    : capacity(burst > 0 ? burst : std::max(1, calls_per_minute / 6)), tokensPerMs(calls_per_minute / 60000.0) {
+    tokens = capacity;
+    lastRefill = Clock::now();
+    blockedUntil = lastRefill;
+}
+
+void RateLimiter::refill(Clock::time_point now) {
+    double elapsed = duration<double, std::milli>(now - lastRefill).count();
+    tokens = std::min(capacity, tokens + elapsed * tokensPerMs);
+    lastRefill = now;
+}
+
+milliseconds RateLimiter::tryAcquire() {
+    QMutexLocker locker(&mutex);
+    auto now = Clock::now();
+    if (now < blockedUntil) return duration_cast<milliseconds>(blockedUntil - now) + milliseconds(1);
+    refill(now);
+    if (tokens >= 1.0) {
+        tokens -= 1.0;
+        return milliseconds(0);
+    }
+    return milliseconds(static_cast<qint64>(std::ceil((1.0 - tokens) / tokensPerMs)));
+}
+
+void RateLimiter::updateFromHeaders(int limit, int remaining, int resetSeconds) {
+    QMutexLocker locker(&mutex);
+    auto now = Clock::now();
+    refill(now);
+    // Follow the server's budget both ways, staying a little under it so requests already in flight don't
+    // push us over.
+    if (limit > 0) tokensPerMs = limit * 0.95 / 60000.0;
+    if (remaining >= 0) tokens = std::min(tokens, double(remaining));
+    if (remaining == 0 && resetSeconds > 0) blockedUntil = std::max(blockedUntil, now + seconds(resetSeconds));
+}
+
+milliseconds RateLimiter::backoff(milliseconds retryAfter) {
+    QMutexLocker locker(&mutex);
+    int step = std::min(consecutiveBackoffs++, 6);
+    milliseconds delay = retryAfter.count() > 0 ? retryAfter : milliseconds(1000 << step);
+    delay += milliseconds(QRandomGenerator::global()->bounded(250 * (step + 1)));
+    tokens = 0;
+    blockedUntil = std::max(blockedUntil, Clock::now() + delay);
+    return delay;
+}
+
+void RateLimiter::recordSuccess() {
+    QMutexLocker locker(&mutex);
+    consecutiveBackoffs = 0;
+}
@@ -0,0 +1,35 @@
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <QMutex>
+#include <chrono>
+
+// Token bucket: allows bursts of up to `burst` calls, refills at calls_per_minute, and never sleeps.
+// tryAcquire() either takes a token or says how long until one is available, so the caller can
+// schedule a retry instead of parking a thread.
+class RateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    RateLimiter(int calls_per_minute, int burst = 0);
+
+    std::chrono::milliseconds tryAcquire();
+    // Recalibrates from X-Ratelimit-Limit/-Remaining/-Reset.
+    void updateFromHeaders(int limit, int remaining, int resetSeconds);
+    // Called on HTTP 429: blocks the bucket for retryAfter (or an exponential step) plus jitter.
+    std::chrono::milliseconds backoff(std::chrono::milliseconds retryAfter);
+    void recordSuccess();
+
+private:
+    void refill(Clock::time_point now);
+
+    QMutex mutex;
+    double capacity;
+    double tokens;
+    double tokensPerMs;
+    Clock::time_point lastRefill;
+    Clock::time_point blockedUntil;
+    int consecutiveBackoffs = 0;
+};
+
+#endif // RATELIMITER_H
@@ -0,0 +1,186 @@
+#include "ResultsModel.h"
+
+#include <QAbstractItemView>
+#include <QColor>
+#include <QPainter>
+#include <algorithm>
+
+const int FRAME_MS = 16;
+const QColor HIGHLIGHT_COLOR("#27ae60");
+
+static QColor tagColor(ResultRow::Tag tag) {
+    switch (tag) {
+    case ResultRow::Tag::Found: return QColor("#27ae60");
+    case ResultRow::Tag::Fallback: return QColor("#f39c12");
+    case ResultRow::Tag::WebFallback: return QColor("#1abc9c");
+    case ResultRow::Tag::Update: return QColor("#3498db");
+    case ResultRow::Tag::Dependency: return QColor("#8e44ad");
+    case ResultRow::Tag::Complete: return QColor("#2ecc71");
+    case ResultRow::Tag::Error: return QColor("#e74c3c");
+    case ResultRow::Tag::None: break;
+    }
+    return QColor();
+}
+
+ResultsModel::ResultsModel(const QStringList& headers, QObject* parent) : QAbstractTableModel(parent), headers(headers) {
+    clock.start();
+}
+
+ResultRow::Tag ResultsModel::tagFor(const QString& searchTag) {
+    if (searchTag == "found") return ResultRow::Tag::Found;
+    if (searchTag == "fallback") return ResultRow::Tag::Fallback;
+    if (searchTag == "web_fallback") return ResultRow::Tag::WebFallback;
+    if (searchTag == "update") return ResultRow::Tag::Update;
+    if (searchTag == "dependency") return ResultRow::Tag::Dependency;
+    return ResultRow::Tag::None;
+}
+
+int ResultsModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : visibleRows;
+}
+
+int ResultsModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : headers.size();
+}
+
+QVariant ResultsModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= visibleRows) return QVariant();
+    const ResultRow& r = rows[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+        if (index.column() == NameColumn) return r.name;
+        if (index.column() == StatusColumn) return r.status;
+        return r.progress < 0 ? QString() : QString::number(r.progress) + "%";
+    case SortRole:
+        if (index.column() == NameColumn) return r.name;
+        if (index.column() == StatusColumn) return r.status;
+        return int(r.progress);
+    case Qt::ForegroundRole:
+        if (index.column() == StatusColumn && r.tag != ResultRow::Tag::None) return tagColor(r.tag);
+        return QVariant();
+    case KeyRole:
+        return r.key;
+    case HighlightRole: {
+        if (r.highlightStartMs < 0) return 0.0;
+        qint64 age = clock.elapsed() - r.highlightStartMs;
+        return age >= HIGHLIGHT_MS ? 0.0 : 1.0 - double(age) / HIGHLIGHT_MS;
+    }
+    }
+    return QVariant();
+}
+
+QVariant ResultsModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole || section < 0 || section >= headers.size()) return QVariant();
+    return headers[section];
+}
+
+int ResultsModel::append(const QString& key, const QString& projectId, const QString& name, const QString& status, ResultRow::Tag tag) {
+    ResultRow r;
+    r.key = key;
+    r.projectId = projectId;
+    r.name = name;
+    r.status = status;
+    r.tag = tag;
+    rows.append(r);
+    int index = rows.size() - 1;
+    if (!key.isEmpty()) rowByKey.insert(key, index);
+    if (!projectId.isEmpty() && !rowByProjectId.contains(projectId)) rowByProjectId.insert(projectId, index);
+    scheduleFlush();
+    return index;
+}
+
+void ResultsModel::clear() {
+    beginResetModel();
+    rows.clear();
+    visibleRows = 0;
+    rowByKey.clear();
+    rowByProjectId.clear();
+    dirty.clear();
+    endResetModel();
+}
+
+int ResultsModel::find(const QString& iid) const {
+    if (int r = rowByKey.value(iid, -1); r >= 0) return r;
+    return rowByProjectId.value(iid, -1);
+}
+
+QStringList ResultsModel::names() const {
+    QStringList names;
+    names.reserve(rows.size());
+    for (const ResultRow& r : rows) names.append(r.name);
+    return names;
+}
+
+void ResultsModel::setStatus(int r, const QString& status, ResultRow::Tag tag) {
+    if (r < 0 || r >= rows.size()) return;
+    rows[r].status = status;
+    rows[r].tag = tag;
+    touch(r);
+}
+
+void ResultsModel::setProgress(int r, int percent) {
+    if (r < 0 || r >= rows.size() || rows[r].progress == percent) return;
+    rows[r].progress = qint8(qBound(0, percent, 100));
+    touch(r);
+}
+
+void ResultsModel::highlight(int r) {
+    if (r < 0 || r >= rows.size()) return;
+    rows[r].highlightStartMs = clock.elapsed();
+    highlightEndMs = rows[r].highlightStartMs + HIGHLIGHT_MS;
+    emit highlightStarted();
+}
+
+void ResultsModel::touch(int r) {
+    // Rows not published yet are picked up by the insert itself.
+    if (r >= visibleRows) return;
+    dirty.insert(r);
+    scheduleFlush();
+}
+
+void ResultsModel::scheduleFlush() {
+    if (flushQueued) return;
+    flushQueued = true;
+    QTimer::singleShot(0, this, &ResultsModel::flush);
+}
+
+void ResultsModel::flush() {
+    flushQueued = false;
+    if (!dirty.isEmpty()) {
+        // Concurrent downloads touch rows all over the table; one signal per contiguous run keeps
+        // proxies from re-examining everything in between.
+        QList<int> changed(dirty.begin(), dirty.end());
+        dirty.clear();
+        std::sort(changed.begin(), changed.end());
+        for (int i = 0; i < changed.size();) {
+            int j = i;
+            while (j + 1 < changed.size() && changed[j + 1] == changed[j] + 1) ++j;
+            emit dataChanged(index(changed[i], 0), index(changed[j], headers.size() - 1), {Qt::DisplayRole, Qt::ForegroundRole, SortRole});
+            i = j + 1;
+        }
+    }
+    if (rows.size() > visibleRows) {
+        beginInsertRows(QModelIndex(), visibleRows, rows.size() - 1);
+        visibleRows = rows.size();
+        endInsertRows();
+    }
+}
+
+ResultsDelegate::ResultsDelegate(QAbstractItemView* view, ResultsModel* model) : QStyledItemDelegate(view), view(view), model(model) {
+    frameTimer.setInterval(FRAME_MS);
+    QObject::connect(model, &ResultsModel::highlightStarted, &frameTimer, qOverload<>(&QTimer::start));
+    QObject::connect(&frameTimer, &QTimer::timeout, view, [this]() {
+        this->view->viewport()->update();
+        if (!this->model->isHighlighting()) frameTimer.stop();
+    });
+}
+
+void ResultsDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    double strength = index.data(ResultsModel::HighlightRole).toDouble();
+    if (strength > 0) {
+        QColor color = HIGHLIGHT_COLOR;
+        color.setAlphaF(strength);
+        painter->fillRect(option.rect, color);
+    }
+    QStyledItemDelegate::paint(painter, option, index);
+}
@@ -0,0 +1,95 @@
+#ifndef RESULTSMODEL_H
+#define RESULTSMODEL_H
+
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <QStyledItemDelegate>
+#include <QTimer>
+
+class QAbstractItemView;
+
+// One line of the results lists. Rows are only ever appended or cleared, so a row's index is stable
+// and doubles as its handle.
+struct ResultRow {
+    enum class Tag : quint8 { None, Found, Fallback, WebFallback, Update, Dependency, Complete, Error };
+
+    QString key;        // Search query for roots, project id for dependencies: the iid downloads report.
+    QString projectId;
+    QString name;
+    QString status;
+    qint64 highlightStartMs = -1;
+    qint8 progress = -1;
+    Tag tag = Tag::None;
+};
+
+// Flat table behind the Available and Not Found lists, stored as one contiguous array. Appends and
+// updates are collected and published together on the next event-loop pass, so a burst of search
+// results or download progress costs one insert and a few dataChanged ranges rather than one per row.
+class ResultsModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum Column { NameColumn, StatusColumn, ProgressColumn };
+    enum Role { KeyRole = Qt::UserRole, SortRole, HighlightRole };
+    static const int HIGHLIGHT_MS = 800;
+
+    explicit ResultsModel(const QStringList& headers, QObject* parent = nullptr);
+
+    // Maps ModSearch result tags ("found", "fallback", ...) to row tags.
+    static ResultRow::Tag tagFor(const QString& searchTag);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // Returns the new row. It is visible to views after the next flush, but can be updated right away.
+    int append(const QString& key, const QString& projectId, const QString& name, const QString& status, ResultRow::Tag tag);
+    void clear();
+    // Every row, including ones not yet flushed to views.
+    int size() const { return rows.size(); }
+    // Row for a download iid: the key first, then the project id. -1 if there is none.
+    int find(const QString& iid) const;
+    const ResultRow& row(int r) const { return rows[r]; }
+    QStringList names() const;
+
+    void setStatus(int r, const QString& status, ResultRow::Tag tag);
+    void setProgress(int r, int percent);
+    // Starts the fading highlight on a row; see ResultsDelegate.
+    void highlight(int r);
+    bool isHighlighting() const { return clock.elapsed() < highlightEndMs; }
+
+signals:
+    void highlightStarted();
+
+private:
+    void touch(int r);
+    void scheduleFlush();
+    void flush();
+
+    QStringList headers;
+    QList<ResultRow> rows;
+    int visibleRows = 0;
+    QHash<QString, int> rowByKey;
+    QHash<QString, int> rowByProjectId;
+    QSet<int> dirty;
+    bool flushQueued = false;
+    QElapsedTimer clock;
+    qint64 highlightEndMs = 0;
+};
+
+// Paints the highlight behind rows that were just found or finished downloading. A single timer
+// repaints the view while any highlight is still fading, instead of one animation per row.
+class ResultsDelegate : public QStyledItemDelegate {
+public:
+    ResultsDelegate(QAbstractItemView* view, ResultsModel* model);
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+private:
+    QAbstractItemView* view;
+    ResultsModel* model;
+    QTimer frameTimer;
+};
+
+#endif // RESULTSMODEL_H
@@ -0,0 +1,142 @@
+#include "StatsPanel.h"
+#include "HttpEngine.h"
+#include "Tracer.h"
+
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPainter>
+#include <QPushButton>
+#include <QTimer>
+#include <QVBoxLayout>
+#include <algorithm>
+
+const int STATS_REFRESH_MS = 500;
+const qint64 RATE_WINDOW_US = 5000000;
+
+LatencyHistogram::LatencyHistogram(const QString& title, QWidget* parent) : QWidget(parent), title(title) {
+    setMinimumHeight(120);
+}
+
+void LatencyHistogram::add(qint64 micros) {
+    qint64 ms = micros / 1000;
+    int bucket = 0;
+    while (ms > 0 && bucket < BUCKETS - 1) { ms >>= 1; ++bucket; }
+    counts[bucket]++;
+    total++;
+    update();
+}
+
+void LatencyHistogram::clear() {
+    counts.fill(0);
+    total = 0;
+    update();
+}
+
+void LatencyHistogram::paintEvent(QPaintEvent*) {
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QColor("#ecf0f1"));
+    QFontMetrics fm = painter.fontMetrics();
+    painter.drawText(QRect(0, 0, width(), fm.height()), Qt::AlignLeft, QString("%1 (%2 requests)").arg(title).arg(total));
+    QRect plot(0, fm.height() + 4, width(), height() - 2 * fm.height() - 8);
+    qint64 peak = *std::max_element(counts.begin(), counts.end());
+    double barWidth = plot.width() / double(BUCKETS);
+    for (int i = 0; i < BUCKETS; ++i) {
+        QRectF slot(plot.left() + i * barWidth, plot.top(), barWidth, plot.height());
+        if (peak > 0 && counts[i] > 0) {
+            double h = qMax(1.0, plot.height() * double(counts[i]) / peak);
+            painter.fillRect(QRectF(slot.left() + 1, slot.bottom() - h, barWidth - 2, h), QColor("#3498db"));
+        }
+        // Label every other bucket with its upper bound so the axis stays readable when the dock is narrow.
+        if (i % 2 == 0) {
+            QString label = i == 0 ? "1ms" : (i < 10 ? QString("%1ms").arg(1 << i) : QString("%1s").arg((1 << i) / 1000));
+            painter.drawText(QRectF(slot.left(), plot.bottom() + 2, barWidth * 2, fm.height()), Qt::AlignLeft, label);
+        }
+    }
+}
+
+StatsPanel::StatsPanel(HttpEngine* http, QWidget* parent) : QWidget(parent), http(http) {
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    rateLabel = new QLabel();
+    throughputLabel = new QLabel();
+    totalsLabel = new QLabel();
+    phaseLabel = new QLabel();
+    phaseLabel->setWordWrap(true);
+    latencyHistogram = new LatencyHistogram("Request latency");
+    ttfbHistogram = new LatencyHistogram("Time to first byte");
+    QPushButton* exportButton = new QPushButton("Export Trace...");
+    QPushButton* resetButton = new QPushButton("Reset");
+    QHBoxLayout* buttons = new QHBoxLayout();
+    buttons->addWidget(resetButton);
+    buttons->addWidget(exportButton);
+    layout->addWidget(rateLabel);
+    layout->addWidget(throughputLabel);
+    layout->addWidget(totalsLabel);
+    layout->addWidget(phaseLabel);
+    layout->addWidget(latencyHistogram);
+    layout->addWidget(ttfbHistogram);
+    layout->addStretch();
+    layout->addLayout(buttons);
+    connect(exportButton, &QPushButton::clicked, this, &StatsPanel::exportTrace);
+    connect(resetButton, &QPushButton::clicked, this, &StatsPanel::reset);
+    lastBytes = http->bytesReceived();
+    refreshTimer = new QTimer(this);
+    connect(refreshTimer, &QTimer::timeout, this, &StatsPanel::refresh);
+    refreshTimer->start(STATS_REFRESH_MS);
+    refresh();
+}
+
+void StatsPanel::addEvent(const TraceEvent& event) {
+    if (qstrcmp(event.category, "parse") == 0) {
+        parseCount++;
+        parseUs += event.durationUs;
+        return;
+    }
+    if (qstrcmp(event.category, "http") != 0) return;
+    recentRequests.push_back(event.startUs + event.durationUs);
+    requestCount++;
+    requestBytes += event.bytes;
+    queueUs += event.queueUs;
+    rateLimitUs += event.rateLimitUs;
+    ttfbUs += event.ttfbUs;
+    transferUs += event.transferUs;
+    latencyHistogram->add(event.durationUs);
+    ttfbHistogram->add(event.ttfbUs);
+}
+
+void StatsPanel::refresh() {
+    for (const TraceEvent& event : Tracer::instance().drain()) addEvent(event);
+    qint64 now = Tracer::instance().nowUs();
+    while (!recentRequests.empty() && recentRequests.front() < now - RATE_WINDOW_US) recentRequests.pop_front();
+    qint64 bytes = http->bytesReceived();
+    double instant = (bytes - lastBytes) * 1000.0 / STATS_REFRESH_MS;
+    lastBytes = bytes;
+    bytesPerSecond = 0.7 * bytesPerSecond + 0.3 * instant;
+    auto avgMs = [this](qint64 sum) { return requestCount > 0 ? sum / 1000.0 / requestCount : 0.0; };
+    rateLabel->setText(QString("Requests/s: %1").arg(recentRequests.size() * 1000000.0 / RATE_WINDOW_US, 0, 'f', 1));
+    throughputLabel->setText(QString("Network: %1 MB/s").arg(bytesPerSecond / (1024.0 * 1024.0), 0, 'f', 2));
+    totalsLabel->setText(QString("Requests: %1, %2 MB").arg(requestCount).arg(requestBytes / (1024.0 * 1024.0), 0, 'f', 1));
+    phaseLabel->setText(QString("Average queue %1 ms, rate limit %2 ms, first byte %3 ms, transfer %4 ms. JSON parse %5 ms over %6 documents.")
+                            .arg(avgMs(queueUs), 0, 'f', 1).arg(avgMs(rateLimitUs), 0, 'f', 1).arg(avgMs(ttfbUs), 0, 'f', 1)
+                            .arg(avgMs(transferUs), 0, 'f', 1).arg(parseUs / 1000.0, 0, 'f', 1).arg(parseCount));
+}
+
+void StatsPanel::reset() {
+    recentRequests.clear();
+    requestCount = requestBytes = 0;
+    queueUs = rateLimitUs = ttfbUs = transferUs = 0;
+    parseCount = parseUs = 0;
+    latencyHistogram->clear();
+    ttfbHistogram->clear();
+    refresh();
+}
+
+void StatsPanel::exportTrace() {
+    QString path = QFileDialog::getSaveFileName(this, "Export Trace", "craftpacker-trace.json", "Chrome Trace (*.json)");
+    if (path.isEmpty()) return;
+    // Export drains the tracer itself, so fold in what it collected before the counters miss it.
+    for (const TraceEvent& event : Tracer::instance().drain()) addEvent(event);
+    if (!Tracer::instance().exportChromeTrace(path)) QMessageBox::critical(this, "Error", "Could not write " + path);
+}
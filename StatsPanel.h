@@ -0,0 +1,61 @@
+#ifndef STATSPANEL_H
+#define STATSPANEL_H
+
+#include <QWidget>
+#include <array>
+#include <deque>
+
+class HttpEngine;
+struct TraceEvent;
+class QLabel;
+class QTimer;
+
+// Bar chart of request latencies in power-of-two millisecond buckets (<1, 1-2, 2-4, ... ms).
+class LatencyHistogram : public QWidget {
+    Q_OBJECT
+public:
+    static const int BUCKETS = 16;
+    explicit LatencyHistogram(const QString& title, QWidget* parent = nullptr);
+    void add(qint64 micros);
+    void clear();
+    QSize sizeHint() const override { return QSize(320, 140); }
+protected:
+    void paintEvent(QPaintEvent* event) override;
+private:
+    QString title;
+    std::array<qint64, BUCKETS> counts{};
+    qint64 total = 0;
+};
+
+// Live view of the Tracer: request rate, network throughput, where request time goes, and latency
+// histograms. Drains the tracer on a timer, so it must be the tracer's only consumer.
+class StatsPanel : public QWidget {
+    Q_OBJECT
+public:
+    explicit StatsPanel(HttpEngine* http, QWidget* parent = nullptr);
+public slots:
+    void exportTrace();
+    void reset();
+private:
+    void refresh();
+    void addEvent(const TraceEvent& event);
+
+    HttpEngine* http;
+    QTimer* refreshTimer;
+    QLabel* rateLabel;
+    QLabel* throughputLabel;
+    QLabel* totalsLabel;
+    QLabel* phaseLabel;
+    LatencyHistogram* latencyHistogram;
+    LatencyHistogram* ttfbHistogram;
+    // Request finish times (tracer clock) inside the rate window.
+    std::deque<qint64> recentRequests;
+    qint64 lastBytes = 0;
+    double bytesPerSecond = 0;
+    qint64 requestCount = 0;
+    qint64 requestBytes = 0;
+    qint64 queueUs = 0, rateLimitUs = 0, ttfbUs = 0, transferUs = 0;
+    qint64 parseCount = 0, parseUs = 0;
+};
+
+#endif // STATSPANEL_H
@@ -0,0 +1,147 @@
+#include "Tracer.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QThread>
+
+const int RING_CAPACITY = 2048;
+const int MAX_HISTORY = 100000;
+
+struct Tracer::ThreadBuffer {
+    std::array<TraceEvent, RING_CAPACITY> ring;
+    QAtomicInteger<quint32> head;
+    QAtomicInteger<quint32> tail;
+    QAtomicInteger<bool> alive{true};
+    quint64 threadId = 0;
+};
+
+Tracer::Tracer() : enabled(false) {
+    clock.start();
+}
+
+Tracer& Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::ThreadBuffer* Tracer::localBuffer() {
+    // Marks the buffer as orphaned when its thread exits; drain() prunes it once it is empty.
+    struct BufferOwner {
+        std::shared_ptr<ThreadBuffer> buffer;
+        ~BufferOwner() {
+            if (buffer) buffer->alive.storeRelease(false);
+        }
+    };
+    thread_local BufferOwner owner;
+    if (!owner.buffer) {
+        owner.buffer = std::make_shared<ThreadBuffer>();
+        owner.buffer->threadId = quint64(quintptr(QThread::currentThreadId()));
+        QString name = QThread::currentThread()->objectName();
+        QMutexLocker locker(&mutex);
+        buffers.append(owner.buffer);
+        threadNames.insert(owner.buffer->threadId, name.isEmpty() ? QString("Thread %1").arg(owner.buffer->threadId, 0, 16) : name);
+    }
+    return owner.buffer.get();
+}
+
+void Tracer::record(TraceEvent event) {
+    if (!isEnabled()) return;
+    ThreadBuffer* buffer = localBuffer();
+    event.threadId = buffer->threadId;
+    quint32 head = buffer->head.loadRelaxed();
+    if (head - buffer->tail.loadAcquire() >= quint32(RING_CAPACITY)) {
+        QMutexLocker locker(&mutex);
+        spill.append(std::move(event));
+        return;
+    }
+    buffer->ring[head % RING_CAPACITY] = std::move(event);
+    buffer->head.storeRelease(head + 1);
+}
+
+QList<TraceEvent> Tracer::drain() {
+    QList<TraceEvent> events;
+    QMutexLocker locker(&mutex);
+    for (auto it = buffers.begin(); it != buffers.end();) {
+        ThreadBuffer* buffer = it->get();
+        bool orphaned = !buffer->alive.loadAcquire();
+        quint32 tail = buffer->tail.loadRelaxed();
+        quint32 head = buffer->head.loadAcquire();
+        for (; tail != head; ++tail) events.append(std::move(buffer->ring[tail % RING_CAPACITY]));
+        buffer->tail.storeRelease(tail);
+        if (orphaned) it = buffers.erase(it);
+        else ++it;
+    }
+    events.append(std::move(spill));
+    spill.clear();
+    history.append(events);
+    if (history.size() > MAX_HISTORY) history.remove(0, history.size() - MAX_HISTORY);
+    return events;
+}
+
+bool Tracer::exportChromeTrace(const QString& path) {
+    drain();
+    QJsonArray trace;
+    QMutexLocker locker(&mutex);
+    for (auto it = threadNames.cbegin(); it != threadNames.cend(); ++it) {
+        trace.append(QJsonObject{{"ph", "M"}, {"name", "thread_name"}, {"pid", 1}, {"tid", qint64(it.key())},
+                                 {"args", QJsonObject{{"name", it.value()}}}});
+    }
+    qint64 asyncId = 0;
+    for (const TraceEvent& e : history) {
+        QJsonObject args{{"bytes", e.bytes}};
+        if (e.queueUs < 0) {
+            trace.append(QJsonObject{{"ph", "X"}, {"cat", e.category}, {"name", e.name}, {"pid", 1}, {"tid", qint64(e.threadId)},
+                                     {"ts", e.startUs}, {"dur", e.durationUs}, {"args", args}});
+            continue;
+        }
+        // Requests overlap on the network thread, so each gets its own async track with its phases nested inside.
+        QString id = QString::number(++asyncId);
+        args.insert("queueUs", e.queueUs);
+        args.insert("rateLimitUs", e.rateLimitUs);
+        args.insert("ttfbUs", e.ttfbUs);
+        args.insert("transferUs", e.transferUs);
+        auto span = [&trace, &e, &id](const QString& name, qint64 start, qint64 duration, const QJsonObject& spanArgs) {
+            if (duration < 0) return;
+            QJsonObject common{{"cat", e.category}, {"name", name}, {"pid", 1}, {"tid", qint64(e.threadId)}, {"id", id}};
+            QJsonObject begin = common;
+            begin.insert("ph", "b");
+            begin.insert("ts", start);
+            begin.insert("args", spanArgs);
+            QJsonObject end = common;
+            end.insert("ph", "e");
+            end.insert("ts", start + duration);
+            trace.append(begin);
+            trace.append(end);
+        };
+        qint64 t = e.startUs;
+        span(e.name, t, e.durationUs, args);
+        span("queue", t, e.queueUs, {});
+        t += qMax<qint64>(0, e.queueUs);
+        span("rate limit", t, e.rateLimitUs, {});
+        t += qMax<qint64>(0, e.rateLimitUs);
+        span("waiting for response", t, e.ttfbUs, {});
+        t += qMax<qint64>(0, e.ttfbUs);
+        span("transfer", t, e.transferUs, {});
+    }
+    locker.unlock();
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(QJsonDocument(QJsonObject{{"traceEvents", trace}, {"displayTimeUnit", "ms"}}).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+TraceScope::TraceScope(const char* category, const QString& name, qint64 bytes) : active(Tracer::instance().isEnabled()) {
+    if (!active) return;
+    event.category = category;
+    event.name = name;
+    event.bytes = bytes;
+    event.startUs = Tracer::instance().nowUs();
+}
+
+TraceScope::~TraceScope() {
+    if (!active) return;
+    event.durationUs = Tracer::instance().nowUs() - event.startUs;
+    Tracer::instance().record(std::move(event));
+}
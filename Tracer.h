@@ -0,0 +1,72 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <array>
+#include <memory>
+
+// One finished span. HTTP requests fill in the phase fields; everything else leaves them at -1.
+struct TraceEvent {
+    const char* category = "";
+    QString name;
+    quint64 threadId = 0;
+    qint64 startUs = 0;
+    qint64 durationUs = 0;
+    qint64 bytes = 0;
+    qint64 queueUs = -1;
+    qint64 rateLimitUs = -1;
+    qint64 ttfbUs = -1;
+    qint64 transferUs = -1;
+};
+
+// Process-wide collector, off until setEnabled(true). Each thread records into its own single-producer
+// ring, so the hot path takes no lock; a full ring spills into a mutex-guarded list rather than
+// dropping events. One consumer (the stats panel, or the CLI at exit) drains all rings and keeps a
+// bounded history for Chrome trace export.
+class Tracer {
+public:
+    static Tracer& instance();
+
+    void setEnabled(bool on) { enabled.storeRelaxed(on); }
+    bool isEnabled() const { return enabled.loadRelaxed(); }
+    // Microseconds since the tracer started; the time base of every event.
+    qint64 nowUs() const { return clock.nsecsElapsed() / 1000; }
+
+    void record(TraceEvent event);
+    // Events recorded since the last call, in no particular order. Single consumer only.
+    QList<TraceEvent> drain();
+    // Drains, then writes the whole history as Chrome trace-event JSON (chrome://tracing, Perfetto).
+    bool exportChromeTrace(const QString& path);
+
+private:
+    struct ThreadBuffer;
+    Tracer();
+    ThreadBuffer* localBuffer();
+
+    QElapsedTimer clock;
+    QAtomicInteger<bool> enabled;
+    QMutex mutex;
+    QList<std::shared_ptr<ThreadBuffer>> buffers;
+    QList<TraceEvent> spill;
+    QList<TraceEvent> history;
+    QHash<quint64, QString> threadNames;
+};
+
+// Records the lifetime of a scope as one event.
+class TraceScope {
+public:
+    TraceScope(const char* category, const QString& name, qint64 bytes = 0);
+    ~TraceScope();
+    void setBytes(qint64 n) { event.bytes = n; }
+
+private:
+    TraceEvent event;
+    bool active;
+};
+
+#endif // TRACER_H
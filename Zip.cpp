@@ -0,0 +1,285 @@
+#include "Zip.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <array>
+
+const quint32 LOCAL_HEADER_SIG = 0x04034b50;
+const quint32 CENTRAL_HEADER_SIG = 0x02014b50;
+const quint32 END_OF_CENTRAL_DIR_SIG = 0x06054b50;
+const quint16 FLAG_UTF8 = 0x0800;
+const quint16 DOS_DATE_1980 = 0x21;
+// Entries we read are pack indexes; anything claiming to be bigger is not one.
+const qint64 MAX_ENTRY_SIZE = 64 * 1024 * 1024;
+
+quint32 crc32(const QByteArray& data) {
+    static const std::array<quint32, 256> table = []() {
+        std::array<quint32, 256> t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    quint32 crc = 0xFFFFFFFFu;
+    for (char byte : data) crc = table[(crc ^ quint8(byte)) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// A small RFC 1951 decoder after zlib's puff.c. Qt only exposes zlib-wrapped streams, and ZIP entries are raw deflate.
+// Output is capped at limit bytes: a stream that inflates past it fails as soon as it does, so a small archive
+// can't expand into gigabytes.
+class Inflater {
+public:
+    Inflater(const QByteArray& in, qint64 limit) : in(in), limit(limit) {}
+    std::optional<QByteArray> run();
+
+private:
+    struct Huffman {
+        quint16 count[16];
+        quint16 symbol[288];
+    };
+    int bits(int need);
+    static int build(Huffman& h, const quint16* lengths, int n);
+    int decode(const Huffman& h);
+    bool stored();
+    bool codes(const Huffman& lencode, const Huffman& distcode);
+    bool fixed();
+    bool dynamic();
+    bool fits(qint64 n) const { return out.size() + n <= limit; }
+
+    const QByteArray& in;
+    qint64 limit;
+    qsizetype pos = 0;
+    quint32 bitBuf = 0;
+    int bitCount = 0;
+    bool failed = false;
+    QByteArray out;
+};
+
+int Inflater::bits(int need) {
+    quint64 val = bitBuf;
+    while (bitCount < need) {
+        if (pos >= in.size()) { failed = true; return 0; }
+        val |= quint64(quint8(in[pos++])) << bitCount;
+        bitCount += 8;
+    }
+    bitBuf = quint32(val >> need);
+    bitCount -= need;
+    return int(val & ((1u << need) - 1));
+}
+
+int Inflater::build(Huffman& h, const quint16* lengths, int n) {
+    for (int len = 0; len < 16; ++len) h.count[len] = 0;
+    for (int sym = 0; sym < n; ++sym) h.count[lengths[sym]]++;
+    if (h.count[0] == n) return 0;
+    int left = 1;
+    for (int len = 1; len < 16; ++len) {
+        left <<= 1;
+        left -= h.count[len];
+        if (left < 0) return left;
+    }
+    quint16 offs[16];
+    offs[1] = 0;
+    for (int len = 1; len < 15; ++len) offs[len + 1] = offs[len] + h.count[len];
+    for (int sym = 0; sym < n; ++sym) {
+        if (lengths[sym] != 0) h.symbol[offs[lengths[sym]]++] = quint16(sym);
+    }
+    return left;
+}
+
+int Inflater::decode(const Huffman& h) {
+    int code = 0, first = 0, index = 0;
+    for (int len = 1; len < 16; ++len) {
+        code |= bits(1);
+        if (failed) return -1;
+        int count = h.count[len];
+        if (code - count < first) return h.symbol[index + (code - first)];
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+bool Inflater::stored() {
+    bitBuf = 0;
+    bitCount = 0;
+    if (pos + 4 > in.size()) return false;
+    quint16 len = quint8(in[pos]) | quint8(in[pos + 1]) << 8;
+    quint16 nlen = quint8(in[pos + 2]) | quint8(in[pos + 3]) << 8;
+    pos += 4;
+    if (len != quint16(~nlen) || pos + len > in.size() || !fits(len)) return false;
+    out.append(in.constData() + pos, len);
+    pos += len;
+    return true;
+}
+
+bool Inflater::codes(const Huffman& lencode, const Huffman& distcode) {
+    static const quint16 lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const quint16 lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const quint16 distBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const quint16 distExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    for (;;) {
+        int sym = decode(lencode);
+        if (sym < 0) return false;
+        if (sym < 256) {
+            if (!fits(1)) return false;
+            out.append(char(sym));
+            continue;
+        }
+        if (sym == 256) return true;
+        sym -= 257;
+        if (sym >= 29) return false;
+        int len = lengthBase[sym] + bits(lengthExtra[sym]);
+        sym = decode(distcode);
+        if (sym < 0 || sym >= 30) return false;
+        int dist = distBase[sym] + bits(distExtra[sym]);
+        if (failed || dist > out.size() || !fits(len)) return false;
+        qsizetype from = out.size() - dist;
+        for (int i = 0; i < len; ++i) out.append(out.at(from + i));
+    }
+}
+
+bool Inflater::fixed() {
+    static Huffman lencode, distcode;
+    static bool built = [&]() {
+        quint16 lengths[288];
+        int sym = 0;
+        for (; sym < 144; ++sym) lengths[sym] = 8;
+        for (; sym < 256; ++sym) lengths[sym] = 9;
+        for (; sym < 280; ++sym) lengths[sym] = 7;
+        for (; sym < 288; ++sym) lengths[sym] = 8;
+        build(lencode, lengths, 288);
+        for (sym = 0; sym < 30; ++sym) lengths[sym] = 5;
+        build(distcode, lengths, 30);
+        return true;
+    }();
+    Q_UNUSED(built);
+    return codes(lencode, distcode);
+}
+
+bool Inflater::dynamic() {
+    static const quint8 order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    quint16 lengths[320] = {};
+    Huffman lencode, distcode;
+    int nlen = bits(5) + 257;
+    int ndist = bits(5) + 1;
+    int ncode = bits(4) + 4;
+    if (failed || nlen > 286 || ndist > 30) return false;
+    for (int i = 0; i < ncode; ++i) lengths[order[i]] = quint16(bits(3));
+    if (failed || build(lencode, lengths, 19) != 0) return false;
+    int index = 0;
+    while (index < nlen + ndist) {
+        int sym = decode(lencode);
+        if (sym < 0) return false;
+        if (sym < 16) { lengths[index++] = quint16(sym); continue; }
+        quint16 len = 0;
+        if (sym == 16) {
+            if (index == 0) return false;
+            len = lengths[index - 1];
+            sym = 3 + bits(2);
+        } else if (sym == 17) {
+            sym = 3 + bits(3);
+        } else {
+            sym = 11 + bits(7);
+        }
+        if (failed || index + sym > nlen + ndist) return false;
+        while (sym--) lengths[index++] = len;
+    }
+    if (lengths[256] == 0) return false;
+    int err = build(lencode, lengths, nlen);
+    if (err < 0 || (err > 0 && nlen - lencode.count[0] != 1)) return false;
+    err = build(distcode, lengths + nlen, ndist);
+    if (err < 0 || (err > 0 && ndist - distcode.count[0] != 1)) return false;
+    return codes(lencode, distcode);
+}
+
+std::optional<QByteArray> Inflater::run() {
+    int last = 0;
+    do {
+        last = bits(1);
+        int type = bits(2);
+        if (failed) return std::nullopt;
+        bool ok = type == 0 ? stored() : type == 1 ? fixed() : type == 2 ? dynamic() : false;
+        if (!ok || failed) return std::nullopt;
+    } while (!last);
+    return out;
+}
+
+bool writeZip(const QString& path, const QList<QPair<QString, QByteArray>>& entries) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    QByteArray central;
+    QDataStream dir(&central, QIODevice::WriteOnly);
+    dir.setByteOrder(QDataStream::LittleEndian);
+    for (const auto& entry : entries) {
+        QByteArray name = entry.first.toUtf8();
+        const QByteArray& data = entry.second;
+        // qCompress wraps raw deflate in a 4-byte length plus a zlib header and Adler-32 trailer.
+        QByteArray zlib = qCompress(data, 9);
+        QByteArray deflated = zlib.size() > 10 ? zlib.mid(6, zlib.size() - 10) : QByteArray();
+        bool deflate = !deflated.isEmpty() && deflated.size() < data.size();
+        const QByteArray& payload = deflate ? deflated : data;
+        quint16 method = deflate ? 8 : 0;
+        quint32 crc = crc32(data);
+        quint32 offset = quint32(file.pos());
+        stream << LOCAL_HEADER_SIG << quint16(20) << FLAG_UTF8 << method << quint16(0) << DOS_DATE_1980 << crc
+               << quint32(payload.size()) << quint32(data.size()) << quint16(name.size()) << quint16(0);
+        stream.writeRawData(name.constData(), name.size());
+        stream.writeRawData(payload.constData(), payload.size());
+        dir << CENTRAL_HEADER_SIG << quint16(20) << quint16(20) << FLAG_UTF8 << method << quint16(0) << DOS_DATE_1980 << crc
+            << quint32(payload.size()) << quint32(data.size()) << quint16(name.size()) << quint16(0) << quint16(0)
+            << quint16(0) << quint16(0) << quint32(0) << offset;
+        dir.writeRawData(name.constData(), name.size());
+    }
+    quint32 centralOffset = quint32(file.pos());
+    stream.writeRawData(central.constData(), central.size());
+    stream << END_OF_CENTRAL_DIR_SIG << quint16(0) << quint16(0) << quint16(entries.size()) << quint16(entries.size())
+           << quint32(central.size()) << centralOffset << quint16(0);
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+std::optional<QByteArray> readZipEntry(const QString& path, const QString& entryName) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return std::nullopt;
+    QByteArray archive = file.readAll();
+    auto u16 = [&archive](qsizetype at) { return quint16(quint8(archive[at]) | quint8(archive[at + 1]) << 8); };
+    auto u32 = [&u16](qsizetype at) { return quint32(u16(at)) | quint32(u16(at + 2)) << 16; };
+    // The end-of-central-directory record sits in the last 22 bytes plus an optional comment of up to 64 KiB.
+    qsizetype eocd = -1;
+    for (qsizetype at = archive.size() - 22; at >= 0 && at >= archive.size() - 22 - 0xFFFF; --at) {
+        if (u32(at) == END_OF_CENTRAL_DIR_SIG) { eocd = at; break; }
+    }
+    if (eocd < 0) return std::nullopt;
+    int count = u16(eocd + 10);
+    qsizetype at = u32(eocd + 16);
+    QByteArray wanted = entryName.toUtf8();
+    for (int i = 0; i < count; ++i) {
+        if (at + 46 > archive.size() || u32(at) != CENTRAL_HEADER_SIG) return std::nullopt;
+        quint16 method = u16(at + 10);
+        quint32 crc = u32(at + 16);
+        quint32 compressedSize = u32(at + 20);
+        quint32 size = u32(at + 24);
+        quint16 nameLength = u16(at + 28);
+        qsizetype next = at + 46 + nameLength + u16(at + 30) + u16(at + 32);
+        qsizetype local = u32(at + 42);
+        if (archive.mid(at + 46, nameLength) != wanted) { at = next; continue; }
+        if (local + 30 > archive.size() || u32(local) != LOCAL_HEADER_SIG) return std::nullopt;
+        qsizetype dataStart = local + 30 + u16(local + 26) + u16(local + 28);
+        if (dataStart + compressedSize > archive.size() || size > MAX_ENTRY_SIZE) return std::nullopt;
+        QByteArray payload = archive.mid(dataStart, compressedSize);
+        std::optional<QByteArray> data;
+        if (method == 0) data = payload;
+        // Inflating more than the header's size is as wrong as inflating less, so stop there.
+        else if (method == 8) data = Inflater(payload, size).run();
+        if (!data || data->size() != qsizetype(size) || crc32(*data) != crc) return std::nullopt;
+        return data;
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,17 @@
+#ifndef ZIP_H
+#define ZIP_H
+
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <optional>
+
+// Just enough ZIP for .mrpack files: writes deflated entries and reads stored or deflated ones.
+// No ZIP64, encryption or multi-disk archives. Entries over 64 MiB, or whose data doesn't match the size and
+// CRC in the header, are not read.
+quint32 crc32(const QByteArray& data);
+bool writeZip(const QString& path, const QList<QPair<QString, QByteArray>>& entries);
+std::optional<QByteArray> readZipEntry(const QString& path, const QString& entryName);
+
+#endif // ZIP_H
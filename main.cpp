@@ -0,0 +1,15 @@
+#include "CraftPacker.h"
+
+#include <QApplication>
+
+const QString STYLESHEET = R"( QMainWindow, QDialog { background-color: #2c3e50; color: #ecf0f1; } QMenuBar { background-color: #34495e; color: #ecf0f1; } QMenuBar::item:selected { background-color: #3498db; } QMenu { background-color: #34495e; border: 1px solid #7f8c8d; } QMenu::item:selected { background-color: #3498db; } QGroupBox { border: 1px solid #7f8c8d; border-radius: 5px; margin-top: 1ex; font-weight: bold; color: #ecf0f1; } QGroupBox::title { subcontrol-origin: margin; subcontrol-position: top left; padding: 0 3px; background-color: #2c3e50; } QLabel, QCheckBox { color: #ecf0f1; font-size: 10pt; } QLineEdit, QTextEdit, QComboBox, QListWidget, QSpinBox { background-color: #34495e; color: #ecf0f1; border: 1px solid #7f8c8d; border-radius: 4px; padding: 5px; font-size: 10pt; } QLineEdit:focus, QTextEdit:focus, QComboBox:focus, QListWidget:focus, QSpinBox:focus { border: 1px solid #3498db; } QListWidget::item:hover { background-color: #3a5064; } QListWidget::item:selected { background-color: #3498db; color: white; } QComboBox::drop-down { border: none; } QComboBox::down-arrow { image: url(nul); } QPushButton { background-color: #3498db; color: white; border: none; padding: 8px 16px; border-radius: 4px; font-size: 10pt; font-weight: bold; } QPushButton:hover { background-color: #2980b9; } QPushButton:pressed { background-color: #1f618d; } QPushButton:disabled { background-color: #566573; color: #95a5a6; } QTreeView { background-color: #34495e; color: #ecf0f1; border: 1px solid #7f8c8d; border-radius: 4px; alternate-background-color: #3a5064; } QTreeView::item { padding: 4px; } QTableWidget { background-color: #34495e; color: #ecf0f1; gridline-color: #7f8c8d; } QHeaderView::section { background-color: #3a5064; color: white; padding: 4px; border: 1px solid #7f8c8d; font-weight: bold; } QStatusBar { color: #bdc3c7; } QStatusBar QPushButton { background-color: transparent; border: 1px solid #7f8c8d; padding: 2px 8px; font-size: 8pt; } QStatusBar QPushButton:hover { background-color: #34495e; } QSplitter::handle { background-color: #7f8c8d; } QSplitter::handle:horizontal { width: 2px; } )";
+
+int main(int argc, char *argv[]) {
+    QCoreApplication::setOrganizationName("CraftPacker");
+    QCoreApplication::setApplicationName("CraftPacker");
+    QApplication app(argc, argv);
+    app.setStyleSheet(STYLESHEET);
+    CraftPacker window;
+    window.show();
+    return app.exec();
+}
@@ -0,0 +1,543 @@
+#include "MockModrinthServer.h"
+
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <QUrlQuery>
+#include <algorithm>
+
+const int THROTTLE_TICK_MS = 50;
+const int RATE_WINDOW_MS = 60000;
+const QByteArray JSON_TYPE = "application/json";
+
+struct MockRequest {
+    QByteArray method;
+    QString path;
+    QUrlQuery query;
+    QHash<QByteArray, QByteArray> headers;
+    QByteArray body;
+};
+
+struct MockResponse {
+    int status = 200;
+    QByteArray body;
+    QByteArray contentType = JSON_TYPE;
+    QList<QPair<QByteArray, QByteArray>> headers;
+    // Downloads honour the server's download rate; API answers always go out at once.
+    bool throttled = false;
+};
+
+// Lives on the server thread and owns every socket. Each connection answers one request at a time, in order,
+// like a keep-alive HTTP/1.1 server without pipelining.
+class MockServerWorker : public QObject {
+public:
+    explicit MockServerWorker(MockModrinthServer* server) : server(server) {}
+    bool listen(quint16 port);
+    void close();
+
+private:
+    struct Connection {
+        QByteArray buffer;
+        bool busy = false;
+    };
+    void processNext(QTcpSocket* socket);
+    void handle(QPointer<QTcpSocket> socket, const MockRequest& request);
+    MockResponse route(const MockRequest& request);
+    bool admit(MockResponse& response);
+    MockResponse download(const MockRequest& request);
+    QJsonObject projectJson(const MockModrinthServer::Project& project) const;
+    QJsonObject versionJson(const MockModrinthServer::Project& project, const MockModrinthServer::Version& version) const;
+    const MockModrinthServer::Version* newestFor(const MockModrinthServer::Project& project, const QStringList& loaders, const QStringList& gameVersions) const;
+    void send(QPointer<QTcpSocket> socket, const MockResponse& response, bool close);
+    void sendThrottled(QPointer<QTcpSocket> socket, QByteArray rest, qint64 rate, bool close);
+    void write(QTcpSocket* socket, const QByteArray& data);
+    void finish(QPointer<QTcpSocket> socket, bool close);
+
+    MockModrinthServer* server;
+    QTcpServer* tcp = nullptr;
+    QHash<QTcpSocket*, Connection> connections;
+    qint64 apiRequests = 0;
+    QElapsedTimer window;
+    int windowCount = 0;
+};
+
+static QStringList jsonStrings(const QString& text) {
+    QStringList values;
+    for (const auto& v : QJsonDocument::fromJson(text.toUtf8()).array()) values.append(v.toString());
+    return values;
+}
+
+static bool matches(const QStringList& have, const QStringList& wanted) {
+    if (wanted.isEmpty()) return true;
+    return std::any_of(wanted.cbegin(), wanted.cend(), [&have](const QString& w) { return have.contains(w); });
+}
+
+static QByteArray reasonPhrase(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 206: return "Partial Content";
+    case 304: return "Not Modified";
+    case 404: return "Not Found";
+    case 416: return "Range Not Satisfiable";
+    case 429: return "Too Many Requests";
+    default: return "Internal Server Error";
+    }
+}
+
+bool MockServerWorker::listen(quint16 port) {
+    tcp = new QTcpServer(this);
+    connect(tcp, &QTcpServer::newConnection, this, [this]() {
+        while (QTcpSocket* socket = tcp->nextPendingConnection()) {
+            server->connections.fetchAndAddRelaxed(1);
+            connections.insert(socket, Connection());
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+                connections[socket].buffer += socket->readAll();
+                processNext(socket);
+            });
+            connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+                connections.remove(socket);
+                socket->deleteLater();
+            });
+        }
+    });
+    if (!tcp->listen(QHostAddress::LocalHost, port)) return false;
+    server->listenPort = tcp->serverPort();
+    return true;
+}
+
+void MockServerWorker::close() {
+    if (tcp) tcp->close();
+    const QList<QTcpSocket*> sockets = connections.keys();
+    for (QTcpSocket* socket : sockets) socket->abort();
+    connections.clear();
+}
+
+void MockServerWorker::processNext(QTcpSocket* socket) {
+    auto it = connections.find(socket);
+    if (it == connections.end() || it->busy) return;
+    Connection& conn = *it;
+    qsizetype headerEnd = conn.buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) return;
+    QList<QByteArray> lines = conn.buffer.left(headerEnd).split('\n');
+    QList<QByteArray> requestLine = lines.value(0).trimmed().split(' ');
+    if (requestLine.size() < 2) {
+        socket->disconnectFromHost();
+        return;
+    }
+    MockRequest request;
+    request.method = requestLine[0];
+    QUrl url(QString::fromLatin1(requestLine[1]));
+    request.path = url.path();
+    request.query = QUrlQuery(url);
+    for (int i = 1; i < lines.size(); ++i) {
+        qsizetype colon = lines[i].indexOf(':');
+        if (colon > 0) request.headers.insert(lines[i].left(colon).trimmed().toLower(), lines[i].mid(colon + 1).trimmed());
+    }
+    qsizetype length = request.headers.value("content-length").toLongLong();
+    if (conn.buffer.size() < headerEnd + 4 + length) return;
+    request.body = conn.buffer.mid(headerEnd + 4, length);
+    conn.buffer.remove(0, headerEnd + 4 + length);
+    conn.busy = true;
+    server->requests.fetchAndAddRelaxed(1);
+    {
+        QMutexLocker locker(&server->mutex);
+        ++server->pathCounts[request.path];
+    }
+    handle(QPointer<QTcpSocket>(socket), request);
+}
+
+void MockServerWorker::handle(QPointer<QTcpSocket> socket, const MockRequest& request) {
+    {
+        QMutexLocker locker(&server->mutex);
+        // A stalled request keeps its connection busy for good, like a server that stopped answering.
+        if (!server->stallPrefix.isEmpty() && request.path.startsWith(server->stallPrefix)) return;
+    }
+    bool close = request.headers.value("connection").toLower() == "close";
+    auto respond = [this, socket, request, close]() {
+        if (socket) send(socket, route(request), close);
+    };
+    int latency = server->latencyMs.loadRelaxed();
+    if (latency > 0) QTimer::singleShot(latency, this, respond);
+    else respond();
+}
+
+// Fixed windows, one minute unless a test shortens them, reported through the same X-Ratelimit headers Modrinth
+// sends.
+bool MockServerWorker::admit(MockResponse& response) {
+    int limit = server->rateLimit.loadRelaxed();
+    if (limit <= 0) return true;
+    int windowMs = server->rateWindowMs.loadRelaxed();
+    int windowLimit = qMax(1, int(qint64(limit) * windowMs / RATE_WINDOW_MS));
+    if (!window.isValid() || window.elapsed() >= windowMs) {
+        window.start();
+        windowCount = 0;
+    }
+    bool admitted = windowCount < windowLimit;
+    if (admitted) ++windowCount;
+    QByteArray reset = QByteArray::number((windowMs - window.elapsed() + 999) / 1000);
+    response.headers.append({"X-Ratelimit-Limit", QByteArray::number(limit)});
+    response.headers.append({"X-Ratelimit-Remaining", QByteArray::number(windowLimit - windowCount)});
+    response.headers.append({"X-Ratelimit-Reset", reset});
+    if (!admitted) {
+        server->rateLimited.fetchAndAddRelaxed(1);
+        response.status = 429;
+        response.headers.append({"Retry-After", reset});
+        response.body = R"({"error":"ratelimited"})";
+    }
+    return admitted;
+}
+
+QJsonObject MockServerWorker::projectJson(const MockModrinthServer::Project& project) const {
+    return QJsonObject{{"id", project.id}, {"slug", project.slug}, {"title", project.title}, {"project_type", "mod"},
+                       {"description", "Synthetic project " + project.title}, {"downloads", project.downloads}, {"icon_url", QJsonValue()}};
+}
+
+QJsonObject MockServerWorker::versionJson(const MockModrinthServer::Project& project, const MockModrinthServer::Version& version) const {
+    QJsonArray dependencies;
+    for (const auto& d : version.dependencies) {
+        dependencies.append(QJsonObject{{"project_id", d.projectId.isEmpty() ? QJsonValue() : QJsonValue(d.projectId)},
+                                        {"version_id", d.versionId.isEmpty() ? QJsonValue() : QJsonValue(d.versionId)},
+                                        {"dependency_type", d.type}});
+    }
+    QString url = QString("http://127.0.0.1:%1/files/%2/%3").arg(server->listenPort).arg(version.id, version.filename);
+    QJsonObject file{{"url", url}, {"filename", version.filename}, {"size", version.size}, {"primary", true},
+                     {"hashes", QJsonObject{{"sha1", version.sha1}, {"sha512", version.sha512}}}};
+    return QJsonObject{{"id", version.id}, {"project_id", project.id}, {"name", version.filename}, {"version_number", "1.0.0"},
+                       {"version_type", version.type}, {"loaders", QJsonArray::fromStringList(version.loaders)},
+                       {"game_versions", QJsonArray::fromStringList(version.gameVersions)}, {"files", QJsonArray{file}},
+                       {"dependencies", dependencies}};
+}
+
+const MockModrinthServer::Version* MockServerWorker::newestFor(const MockModrinthServer::Project& project, const QStringList& loaders, const QStringList& gameVersions) const {
+    for (const auto& version : project.versions) {
+        if (matches(version.loaders, loaders) && matches(version.gameVersions, gameVersions)) return &version;
+    }
+    return nullptr;
+}
+
+MockResponse MockServerWorker::route(const MockRequest& request) {
+    MockResponse response;
+    if (request.path.startsWith("/files/")) return download(request);
+    if (!request.path.startsWith("/v2/")) {
+        response.status = 404;
+        return response;
+    }
+    if (!admit(response)) return response;
+    int failEvery = server->failEvery.loadRelaxed();
+    if (failEvery > 0 && ++apiRequests % failEvery == 0) {
+        response.status = 500;
+        response.body = R"({"error":"injected failure"})";
+        return response;
+    }
+    QStringList parts = request.path.mid(4).split('/', Qt::SkipEmptyParts);
+    QJsonDocument doc;
+    if (request.method == "POST" && (parts == QStringList{"version_files"} || parts == QStringList{"version_files", "update"})) {
+        QJsonObject body = QJsonDocument::fromJson(request.body).object();
+        QStringList loaders, gameVersions;
+        for (const auto& v : body["loaders"].toArray()) loaders.append(v.toString());
+        for (const auto& v : body["game_versions"].toArray()) gameVersions.append(v.toString());
+        bool update = parts.size() == 2;
+        QJsonObject byHash;
+        for (const auto& v : body["hashes"].toArray()) {
+            auto it = server->versionsById.constFind(server->versionByHash.value(v.toString()));
+            if (it == server->versionsById.constEnd()) continue;
+            const auto& project = server->projects.at(it->first);
+            const MockModrinthServer::Version* version = update ? newestFor(project, loaders, gameVersions) : &project.versions[it->second];
+            if (version) byHash.insert(v.toString(), versionJson(project, *version));
+        }
+        doc = QJsonDocument(byHash);
+    } else if (parts.size() == 2 && parts[0] == "project") {
+        const MockModrinthServer::Project* project = server->project(parts[1]);
+        if (project) doc = QJsonDocument(projectJson(*project));
+    } else if (parts.size() == 3 && parts[0] == "project" && parts[2] == "version") {
+        const MockModrinthServer::Project* project = server->project(parts[1]);
+        if (project) {
+            QStringList loaders = jsonStrings(request.query.queryItemValue("loaders", QUrl::FullyDecoded));
+            QStringList gameVersions = jsonStrings(request.query.queryItemValue("game_versions", QUrl::FullyDecoded));
+            QJsonArray versions;
+            for (const auto& version : project->versions) {
+                if (matches(version.loaders, loaders) && matches(version.gameVersions, gameVersions)) versions.append(versionJson(*project, version));
+            }
+            doc = QJsonDocument(versions);
+        }
+    } else if (parts == QStringList{"projects"}) {
+        QJsonArray found;
+        for (const QString& id : jsonStrings(request.query.queryItemValue("ids", QUrl::FullyDecoded))) {
+            if (const MockModrinthServer::Project* project = server->project(id)) found.append(projectJson(*project));
+        }
+        doc = QJsonDocument(found);
+    } else if (parts == QStringList{"versions"}) {
+        QJsonArray found;
+        for (const QString& id : jsonStrings(request.query.queryItemValue("ids", QUrl::FullyDecoded))) {
+            auto it = server->versionsById.constFind(id);
+            if (it == server->versionsById.constEnd()) continue;
+            const auto& project = server->projects.at(it->first);
+            found.append(versionJson(project, project.versions[it->second]));
+        }
+        doc = QJsonDocument(found);
+    } else if (parts == QStringList{"search"}) {
+        // Every query word must appear in the title or slug; facets narrow by loader and game version.
+        QStringList words = request.query.queryItemValue("query", QUrl::FullyDecoded).toLower().split(' ', Qt::SkipEmptyParts);
+        QStringList loaders, gameVersions;
+        for (const auto& group : QJsonDocument::fromJson(request.query.queryItemValue("facets", QUrl::FullyDecoded).toUtf8()).array()) {
+            for (const auto& facet : group.toArray()) {
+                QString f = facet.toString();
+                if (f.startsWith("categories:")) loaders.append(f.mid(11));
+                if (f.startsWith("versions:")) gameVersions.append(f.mid(9));
+            }
+        }
+        QList<const MockModrinthServer::Project*> hits;
+        for (const auto& project : std::as_const(server->projects)) {
+            QString haystack = project.title.toLower() + ' ' + project.slug;
+            bool all = std::all_of(words.cbegin(), words.cend(), [&haystack](const QString& w) { return haystack.contains(w); });
+            if (all && newestFor(project, loaders, gameVersions)) hits.append(&project);
+        }
+        std::stable_sort(hits.begin(), hits.end(), [](const auto* a, const auto* b) { return a->downloads > b->downloads; });
+        int offset = request.query.queryItemValue("offset").toInt();
+        int limit = request.query.hasQueryItem("limit") ? request.query.queryItemValue("limit").toInt() : 10;
+        QJsonArray page;
+        for (int i = offset; i < hits.size() && i < offset + limit; ++i) {
+            page.append(QJsonObject{{"project_id", hits[i]->id}, {"slug", hits[i]->slug}, {"title", hits[i]->title}, {"downloads", hits[i]->downloads}});
+        }
+        doc = QJsonDocument(QJsonObject{{"hits", page}, {"offset", offset}, {"limit", limit}, {"total_hits", int(hits.size())}});
+    }
+    if (doc.isNull()) {
+        response.status = 404;
+        response.body = R"({"error":"not_found"})";
+        return response;
+    }
+    response.body = doc.toJson(QJsonDocument::Compact);
+    return response;
+}
+
+MockResponse MockServerWorker::download(const MockRequest& request) {
+    MockResponse response;
+    QStringList parts = request.path.split('/', Qt::SkipEmptyParts);
+    auto it = server->versionsById.constFind(parts.value(1));
+    if (parts.size() != 3 || it == server->versionsById.constEnd()) {
+        response.status = 404;
+        return response;
+    }
+    const MockModrinthServer::Version& version = server->projects.at(it->first).versions[it->second];
+    QByteArray content = MockModrinthServer::fileContent(version.id, version.size);
+    response.contentType = "application/java-archive";
+    response.throttled = true;
+    QByteArray range = request.headers.value("range");
+    if (!range.startsWith("bytes=")) {
+        response.body = content;
+        return response;
+    }
+    qint64 from = range.mid(6, range.indexOf('-') - 6).toLongLong();
+    if (from >= content.size()) {
+        response.status = 416;
+        response.headers.append({"Content-Range", "bytes */" + QByteArray::number(content.size())});
+        return response;
+    }
+    response.status = 206;
+    response.headers.append({"Content-Range", "bytes " + QByteArray::number(from) + "-" + QByteArray::number(content.size() - 1) + "/" + QByteArray::number(content.size())});
+    response.body = content.mid(from);
+    return response;
+}
+
+void MockServerWorker::write(QTcpSocket* socket, const QByteArray& data) {
+    socket->write(data);
+    server->sent.fetchAndAddRelaxed(data.size());
+}
+
+void MockServerWorker::send(QPointer<QTcpSocket> socket, const MockResponse& response, bool close) {
+    QByteArray head = "HTTP/1.1 " + QByteArray::number(response.status) + " " + reasonPhrase(response.status) + "\r\n";
+    head += "Content-Type: " + response.contentType + "\r\n";
+    head += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+    for (const auto& header : response.headers) head += header.first + ": " + header.second + "\r\n";
+    head += close ? "Connection: close\r\n\r\n" : "Connection: keep-alive\r\n\r\n";
+    qint64 rate = server->downloadRate.loadRelaxed();
+    if (!response.throttled || rate <= 0) {
+        write(socket, head + response.body);
+        finish(socket, close);
+        return;
+    }
+    write(socket, head);
+    sendThrottled(socket, response.body, rate, close);
+}
+
+void MockServerWorker::sendThrottled(QPointer<QTcpSocket> socket, QByteArray rest, qint64 rate, bool close) {
+    if (!socket) return;
+    qint64 chunk = qMax<qint64>(1, rate * THROTTLE_TICK_MS / 1000);
+    write(socket, rest.left(chunk));
+    rest.remove(0, qMin<qint64>(chunk, rest.size()));
+    if (rest.isEmpty()) {
+        finish(socket, close);
+        return;
+    }
+    QTimer::singleShot(THROTTLE_TICK_MS, this, [this, socket, rest, rate, close]() { sendThrottled(socket, rest, rate, close); });
+}
+
+void MockServerWorker::finish(QPointer<QTcpSocket> socket, bool close) {
+    if (!socket) return;
+    if (close) {
+        socket->disconnectFromHost();
+        return;
+    }
+    auto it = connections.find(socket.data());
+    if (it == connections.end()) return;
+    it->busy = false;
+    processNext(socket.data());
+}
+
+MockModrinthServer::MockModrinthServer() : worker(new MockServerWorker(this)) {
+    thread.setObjectName("MockModrinthServer");
+    worker->moveToThread(&thread);
+    QObject::connect(&thread, &QThread::finished, worker, &QObject::deleteLater);
+}
+
+MockModrinthServer::~MockModrinthServer() {
+    if (thread.isRunning()) {
+        QMetaObject::invokeMethod(worker, [this]() { worker->close(); }, Qt::BlockingQueuedConnection);
+        thread.quit();
+        thread.wait();
+    } else {
+        delete worker;
+    }
+}
+
+bool MockModrinthServer::start(quint16 port) {
+    thread.start();
+    bool listening = false;
+    QMetaObject::invokeMethod(worker, [this, port, &listening]() { listening = worker->listen(port); }, Qt::BlockingQueuedConnection);
+    return listening;
+}
+
+QString MockModrinthServer::apiBase() const {
+    return QString("http://127.0.0.1:%1/v2").arg(listenPort);
+}
+
+void MockModrinthServer::setStallPrefix(const QString& prefix) {
+    QMutexLocker locker(&mutex);
+    stallPrefix = prefix;
+}
+
+qint64 MockModrinthServer::requestCount(const QString& pathPrefix) const {
+    QMutexLocker locker(&mutex);
+    qint64 count = 0;
+    for (auto it = pathCounts.cbegin(); it != pathCounts.cend(); ++it)
+        if (it.key().startsWith(pathPrefix)) count += it.value();
+    return count;
+}
+
+void MockModrinthServer::resetCounters() {
+    {
+        QMutexLocker locker(&mutex);
+        pathCounts.clear();
+    }
+    connections.storeRelaxed(0);
+    requests.storeRelaxed(0);
+    rateLimited.storeRelaxed(0);
+    sent.storeRelaxed(0);
+}
+
+QByteArray MockModrinthServer::fileContent(const QString& versionId, qint64 size) {
+    // FNV-1a of the id seeds a xorshift generator, so every version gets its own stable bytes.
+    quint32 x = 2166136261u;
+    for (char c : versionId.toUtf8()) x = (x ^ quint8(c)) * 16777619u;
+    if (x == 0) x = 1;
+    QByteArray data(size, Qt::Uninitialized);
+    for (qint64 i = 0; i < size; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        data[i] = char(x >> 24);
+    }
+    return data;
+}
+
+void MockModrinthServer::addProject(Project project) {
+    int index = projects.size();
+    for (int i = 0; i < project.versions.size(); ++i) {
+        Version& version = project.versions[i];
+        if (version.filename.isEmpty()) version.filename = project.slug + "-" + version.id + ".jar";
+        QByteArray content = fileContent(version.id, version.size);
+        version.sha1 = QString::fromLatin1(QCryptographicHash::hash(content, QCryptographicHash::Sha1).toHex());
+        version.sha512 = QString::fromLatin1(QCryptographicHash::hash(content, QCryptographicHash::Sha512).toHex());
+        versionsById.insert(version.id, {index, i});
+        versionByHash.insert(version.sha1, version.id);
+        versionByHash.insert(version.sha512, version.id);
+    }
+    byId.insert(project.id, index);
+    bySlug.insert(project.slug, index);
+    projects.append(std::move(project));
+}
+
+const MockModrinthServer::Project* MockModrinthServer::project(const QString& idOrSlug) const {
+    int index = byId.value(idOrSlug, bySlug.value(idOrSlug, -1));
+    return index < 0 ? nullptr : &projects[index];
+}
+
+// Three or more syllables spelling the number in base 16, so titles stay unique and contain no digits that
+// ModSearch::sanitizeModName would strip.
+static QString syntheticWord(int n) {
+    static const char* const syllables[16] = {"ka", "lo", "mi", "ru", "sen", "ta", "vo", "zen", "bri", "dul", "fa", "gor", "hin", "jel", "nu", "pex"};
+    QString word;
+    for (int digits = 0; digits < 3 || n > 0; ++digits, n /= 16) word.prepend(QString::fromLatin1(syllables[n % 16]));
+    word[0] = word[0].toUpper();
+    return word;
+}
+
+QStringList MockModrinthServer::addSyntheticProjects(int count, const QString& loader, const QString& gameVersion, qint64 fileSize) {
+    static const char* const nouns[] = {"Storage", "Furnaces", "Tweaks", "Maps", "Tools", "Armor", "Biomes", "Mobs", "Optimizer", "Menus", "Lighting", "Farming"};
+    QStringList titles;
+    int first = projects.size();
+    for (int i = first; i < first + count; ++i) {
+        Project project;
+        project.id = QString("P%1").arg(i, 7, 10, QChar('0'));
+        project.title = syntheticWord(i) + " " + nouns[i % 12];
+        project.slug = project.title.toLower().replace(' ', '-');
+        project.downloads = 1000000 - i;
+        Version version;
+        version.id = QString("V%1").arg(i, 7, 10, QChar('0'));
+        version.loaders = {loader};
+        version.gameVersions = {gameVersion};
+        version.size = fileSize;
+        project.versions.append(version);
+        titles.append(project.title);
+        addProject(project);
+    }
+    return titles;
+}
+
+QString MockModrinthServer::addDependencyTree(const QString& prefix, int depth, int fanout, const QString& loader, const QString& gameVersion) {
+    // Built leaves first so every dependency's version id is known when its parent is added.
+    QString root = prefix + "-0-0";
+    QStringList below;
+    for (int level = depth - 1; level >= 0; --level) {
+        int width = 1;
+        for (int i = 0; i < level; ++i) width *= fanout;
+        QStringList current;
+        for (int i = 0; i < width; ++i) {
+            Project project;
+            project.id = QString("%1-%2-%3").arg(prefix).arg(level).arg(i);
+            project.slug = project.id;
+            project.title = project.id;
+            Version version;
+            version.id = "v-" + project.id;
+            version.loaders = {loader};
+            version.gameVersions = {gameVersion};
+            for (int c = 0; c < fanout && level + 1 < depth; ++c) {
+                QString child = below.value(i * fanout + c);
+                version.dependencies.append({child, "v-" + child, "required"});
+            }
+            if (level > 0) version.dependencies.append({root, QString(), "required"});
+            project.versions.append(version);
+            addProject(project);
+            current.append(project.id);
+        }
+        below = current;
+    }
+    return root;
+}
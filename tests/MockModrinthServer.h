@@ -0,0 +1,115 @@
+#ifndef MOCKMODRINTHSERVER_H
+#define MOCKMODRINTHSERVER_H
+
+#include <QAtomicInteger>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+
+class MockServerWorker;
+
+// Local stand-in for the part of the Modrinth v2 API CraftPacker uses (/project, /project/<id>/version,
+// /projects, /versions, /search, /version_files and /version_files/update) plus the file downloads, with
+// Range support. Speaks keep-alive HTTP/1.1 on 127.0.0.1 from its own thread, so blocking engine calls made
+// on the test thread never starve it. Latency, a per-minute rate limit answered with 429, injected 500s,
+// stalled paths and throttled downloads can be changed while it runs; the catalogue is filled in before start().
+class MockModrinthServer {
+public:
+    struct Dependency {
+        QString projectId;
+        QString versionId;
+        QString type = "required";
+    };
+    struct Version {
+        QString id;
+        QStringList loaders;
+        QStringList gameVersions;
+        QString type = "release";
+        QString filename;
+        qint64 size = 16 * 1024;
+        QList<Dependency> dependencies;
+        // Computed by addProject() from fileContent().
+        QString sha1;
+        QString sha512;
+    };
+    struct Project {
+        QString id;
+        QString slug;
+        QString title;
+        qint64 downloads = 0;
+        // Newest first, as the real /version endpoint returns them.
+        QList<Version> versions;
+    };
+
+    MockModrinthServer();
+    ~MockModrinthServer();
+
+    void addProject(Project project);
+    // count projects with pronounceable, unique titles such as "Kalomi Storage" and one release each for the
+    // loader and game version. Returns the titles, ready to be used as a mod list.
+    QStringList addSyntheticProjects(int count, const QString& loader, const QString& gameVersion, qint64 fileSize = 16 * 1024);
+    // A dependency tree depth levels deep in which every mod requires fanout others by pinned version, and every
+    // mod below the root also requires the root, so the graph has cycles. Returns the root's project id.
+    QString addDependencyTree(const QString& prefix, int depth, int fanout, const QString& loader, const QString& gameVersion);
+
+    const Project* project(const QString& idOrSlug) const;
+    // The bytes served for a version's file: deterministic, so hashes match between runs.
+    static QByteArray fileContent(const QString& versionId, qint64 size);
+
+    // Listens on 127.0.0.1; port 0 picks a free one.
+    bool start(quint16 port = 0);
+    quint16 port() const { return listenPort; }
+    QString apiBase() const;
+
+    void setLatencyMs(int ms) { latencyMs.storeRelaxed(qMax(0, ms)); }
+    // API requests beyond this many per minute are answered with 429 and Retry-After. 0 turns the limit off.
+    void setRateLimitPerMinute(int n) { rateLimit.storeRelaxed(qMax(0, n)); }
+    // Counts the limit in windows this long, each admitting its share of the per-minute budget, so a test sees
+    // Retry-After expire in about a second instead of a minute. The headers still report the per-minute limit.
+    void setRateWindowMs(int ms) { rateWindowMs.storeRelaxed(qMax(1, ms)); }
+    // Every n-th API request fails with 500. 0 turns failures off.
+    void setFailEvery(int n) { failEvery.storeRelaxed(qMax(0, n)); }
+    // Requests whose path starts with this are read and never answered. Empty turns stalling off.
+    void setStallPrefix(const QString& prefix);
+    // Downloads are sent at this rate; 0 sends them as fast as the socket takes them.
+    void setDownloadBytesPerSecond(qint64 n) { downloadRate.storeRelaxed(qMax<qint64>(0, n)); }
+
+    qint64 connectionCount() const { return connections.loadRelaxed(); }
+    qint64 requestCount() const { return requests.loadRelaxed(); }
+    // Requests whose path starts with pathPrefix, e.g. "/v2/projects".
+    qint64 requestCount(const QString& pathPrefix) const;
+    qint64 rateLimitedCount() const { return rateLimited.loadRelaxed(); }
+    qint64 bytesSent() const { return sent.loadRelaxed(); }
+    void resetCounters();
+
+private:
+    friend class MockServerWorker;
+
+    QList<Project> projects;
+    QHash<QString, int> byId;
+    QHash<QString, int> bySlug;
+    // Version id to (project, version) indices.
+    QHash<QString, QPair<int, int>> versionsById;
+    QHash<QString, QString> versionByHash;
+
+    mutable QMutex mutex;
+    QString stallPrefix;
+    QHash<QString, qint64> pathCounts;
+    QThread thread;
+    MockServerWorker* worker;
+    quint16 listenPort = 0;
+    QAtomicInteger<int> latencyMs{0};
+    QAtomicInteger<int> rateLimit{0};
+    QAtomicInteger<int> rateWindowMs{60000};
+    QAtomicInteger<int> failEvery{0};
+    QAtomicInteger<qint64> downloadRate{0};
+    QAtomicInteger<qint64> connections{0};
+    QAtomicInteger<qint64> requests{0};
+    QAtomicInteger<qint64> rateLimited{0};
+    QAtomicInteger<qint64> sent{0};
+};
+
+#endif // MOCKMODRINTHSERVER_H
@@ -0,0 +1,401 @@
+#include "DependencyResolver.h"
+#include "DownloadScheduler.h"
+#include "FileHash.h"
+#include "MockModrinthServer.h"
+#include "ModSearch.h"
+#include "NameIndex.h"
+#include "RateLimiter.h"
+#include "Tracer.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMap>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#if defined(Q_OS_WIN)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// End-to-end scenarios against MockModrinthServer. Every scenario gets a fresh server, engine and client, so
+// none of them rides on another's connections, and prints one JSON line: wall time, requests sent and answered,
+// connections opened, bytes received, peak thread count and peak memory. Peak memory is the process's high-water
+// mark, so run one scenario per process when comparing it.
+
+const QString LOADER = "fabric";
+const QString GAME_VERSION = "1.20.1";
+const int THREAD_SAMPLE_MS = 5;
+// What CraftPacker asks of Modrinth, and what the rate-limit scenario's server allows when --rate-limit isn't set.
+const int CLIENT_CALLS_PER_MINUTE = 280;
+const int SERVER_CALLS_PER_MINUTE = 300;
+// Per-download rate for the concurrency sweep when --download-rate isn't set, so one transfer can't fill the
+// loopback link on its own.
+const qint64 SWEEP_BYTES_PER_SECOND = 1024 * 1024;
+
+static qint64 peakMemoryKiB() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return -1;
+    return qint64(counters.PeakWorkingSetSize / 1024);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#if defined(Q_OS_MACOS)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+// Memory the process holds right now, unlike the high-water mark above, or -1 where that can't be read.
+static qint64 residentMemoryKiB() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return -1;
+    return qint64(counters.WorkingSetSize / 1024);
+#elif defined(Q_OS_LINUX)
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly)) return -1;
+    for (const QByteArray& line : status.readAll().split('\n')) {
+        if (line.startsWith("VmRSS:")) return line.mid(6).trimmed().split(' ').first().toLongLong();
+    }
+    return -1;
+#else
+    return -1;
+#endif
+}
+
+// Threads in this process, or -1 where that can't be read.
+static int threadCount() {
+#if defined(Q_OS_LINUX)
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly)) return -1;
+    for (const QByteArray& line : status.readAll().split('\n')) {
+        if (line.startsWith("Threads:")) return line.mid(8).trimmed().toInt();
+    }
+#endif
+    return -1;
+}
+
+struct BenchOptions {
+    int latencyMs = 20;
+    int rateLimit = 0;
+    int failEvery = 0;
+    qint64 downloadRate = 0;
+};
+
+class Bench {
+public:
+    explicit Bench(const BenchOptions& options) : options(options), limiter(CLIENT_CALLS_PER_MINUTE), modrinth(&http) {}
+    ~Bench() { stopSampler(); }
+
+    // Starts the server once the scenario has filled in its catalogue, then starts the clock.
+    bool begin() {
+        server.setLatencyMs(options.latencyMs);
+        server.setRateLimitPerMinute(options.rateLimit);
+        server.setFailEvery(options.failEvery);
+        server.setDownloadBytesPerSecond(options.downloadRate);
+        if (!server.start()) return false;
+        modrinth.setApiBase(server.apiBase());
+        sampling = true;
+        sampler = std::thread([this]() {
+            while (sampling) {
+                peakThreads = std::max(peakThreads.load(), threadCount());
+                std::this_thread::sleep_for(std::chrono::milliseconds(THREAD_SAMPLE_MS));
+            }
+        });
+        timer.start();
+        return true;
+    }
+    qint64 elapsed() const { return timer.elapsed(); }
+    // Puts API requests behind the same limiter the app uses for Modrinth.
+    void limitRequests() { http.setRateLimiter(QUrl(server.apiBase()).host(), &limiter); }
+
+    // Downloads into dir with one scheduler and returns the number of files that failed.
+    int download(const QList<ModInfo>& mods, const QString& dir, int maxConcurrent = 8, int maxPerHost = 6) {
+        DownloadScheduler scheduler(&http);
+        scheduler.setMaxConcurrent(maxConcurrent);
+        scheduler.setMaxPerHost(maxPerHost);
+        int failed = 0;
+        QObject::connect(&scheduler, &DownloadScheduler::finished, [&failed](const QString&, const QString& error) {
+            if (!error.isEmpty()) ++failed;
+        });
+        QEventLoop loop;
+        // Queued, so a batch that finishes inside start() still ends the loop.
+        QObject::connect(&scheduler, &DownloadScheduler::allFinished, &loop, &QEventLoop::quit, Qt::QueuedConnection);
+        for (const auto& mod : mods) scheduler.enqueue(mod, dir);
+        scheduler.start();
+        loop.exec();
+        return failed;
+    }
+
+    QJsonObject finish(QJsonObject result) {
+        qint64 wall = timer.elapsed();
+        stopSampler();
+        result["wallMs"] = wall;
+        result["requests"] = http.requestCount();
+        result["serverRequests"] = server.requestCount();
+        result["connections"] = server.connectionCount();
+        result["rateLimited"] = server.rateLimitedCount();
+        result["bytesReceived"] = http.bytesReceived();
+        result["peakThreads"] = peakThreads.load();
+        result["peakMemoryKiB"] = peakMemoryKiB();
+        return result;
+    }
+
+    BenchOptions options;
+    MockModrinthServer server;
+    RateLimiter limiter;
+    HttpEngine http;
+    ModrinthClient modrinth;
+
+private:
+    void stopSampler() {
+        sampling = false;
+        if (sampler.joinable()) sampler.join();
+    }
+
+    QElapsedTimer timer;
+    std::thread sampler;
+    std::atomic<bool> sampling{false};
+    std::atomic<int> peakThreads{-1};
+};
+
+// Search, resolve and download a pack of synthetic mods, the way craftpacker-cli does.
+static QJsonObject searchPack(Bench& bench, int mods) {
+    QStringList names = bench.server.addSyntheticProjects(mods, LOADER, GAME_VERSION);
+    if (!bench.begin()) return {};
+    std::vector<ModSearch::Result> searches(names.size());
+    QThreadPool pool;
+    pool.setMaxThreadCount(QThread::idealThreadCount());
+    for (int i = 0; i < names.size(); ++i) {
+        pool.start([&bench, &searches, &names, i]() { searches[i] = ModSearch(&bench.modrinth).find(names.at(i), LOADER, GAME_VERSION); });
+    }
+    pool.waitForDone();
+    qint64 searchMs = bench.elapsed();
+    QList<ModInfo> roots;
+    for (const auto& search : searches) {
+        if (search.mod) roots.append(*search.mod);
+    }
+    ResolutionResult resolution = DependencyResolver(&bench.modrinth).resolve(roots, LOADER, GAME_VERSION);
+    qint64 resolveMs = bench.elapsed() - searchMs;
+    QTemporaryDir dir;
+    int failed = bench.download(resolution.downloadQueue, dir.path());
+    return bench.finish({{"mods", mods}, {"found", int(roots.size())}, {"searchMs", searchMs}, {"resolveMs", resolveMs}, {"failedDownloads", failed}});
+}
+
+// Resolve a dependency tree from its root; fanout 1 gives a chain depth mods long.
+static QJsonObject dependencyTree(Bench& bench, int depth, int fanout) {
+    QString root = bench.server.addDependencyTree("tree", depth, fanout, LOADER, GAME_VERSION);
+    if (!bench.begin()) return {};
+    std::optional<ModInfo> mod = bench.modrinth.getModInfo(root, LOADER, GAME_VERSION);
+    if (!mod) return bench.finish({{"error", "root not found"}});
+    ResolutionResult resolution = DependencyResolver(&bench.modrinth).resolve({*mod}, LOADER, GAME_VERSION);
+    return bench.finish({{"depth", depth}, {"fanout", fanout}, {"files", int(resolution.downloadQueue.size())}, {"levels", resolution.levels},
+                         {"unresolved", int(resolution.unresolved.size())}});
+}
+
+// Resolve a closure of about 1000 mods and report what each resolved mod costs: time in the traced JSON parsing
+// of project and version documents, and memory still held once the resolution is done. The server and client
+// are running before the first reading, so the difference is mostly the resolution and the cached responses.
+static QJsonObject closureCost(Bench& bench, int depth, int fanout) {
+    QString root = bench.server.addDependencyTree("closure", depth, fanout, LOADER, GAME_VERSION);
+    if (!bench.begin()) return {};
+    Tracer& tracer = Tracer::instance();
+    tracer.drain();
+    tracer.setEnabled(true);
+    qint64 residentBefore = residentMemoryKiB();
+    std::optional<ModInfo> mod = bench.modrinth.getModInfo(root, LOADER, GAME_VERSION);
+    if (!mod) return bench.finish({{"error", "root not found"}});
+    ResolutionResult resolution = DependencyResolver(&bench.modrinth).resolve({*mod}, LOADER, GAME_VERSION);
+    qint64 residentAfter = residentMemoryKiB();
+    tracer.setEnabled(false);
+    qint64 parseUs = 0;
+    int parses = 0;
+    for (const TraceEvent& event : tracer.drain()) {
+        if (qstrcmp(event.category, "parse") != 0) continue;
+        parseUs += event.durationUs;
+        ++parses;
+    }
+    int files = qMax(1, int(resolution.downloadQueue.size()));
+    qint64 retainedKiB = residentBefore < 0 || residentAfter < 0 ? -1 : residentAfter - residentBefore;
+    return bench.finish({{"depth", depth}, {"fanout", fanout}, {"files", int(resolution.downloadQueue.size())},
+                         {"unresolved", int(resolution.unresolved.size())}, {"parses", parses}, {"parseMs", parseUs / 1000.0},
+                         {"parseUsPerMod", double(parseUs) / files}, {"retainedKiB", retainedKiB},
+                         {"retainedBytesPerMod", retainedKiB < 0 ? -1.0 : retainedKiB * 1024.0 / files}});
+}
+
+// Import a folder of jars: hash every file, identify them by hash and look for updates, like Import from Folder.
+static QJsonObject importJars(Bench& bench, int jars) {
+    QStringList titles = bench.server.addSyntheticProjects(jars, LOADER, GAME_VERSION);
+    QTemporaryDir dir;
+    for (const QString& title : titles) {
+        const MockModrinthServer::Project* project = bench.server.project(title.toLower().replace(' ', '-'));
+        const MockModrinthServer::Version& version = project->versions.first();
+        QFile jar(dir.path() + "/" + version.filename);
+        if (jar.open(QIODevice::WriteOnly)) jar.write(MockModrinthServer::fileContent(version.id, version.size));
+    }
+    if (!bench.begin()) return {};
+    QStringList hashes;
+    for (const QFileInfo& jar : QDir(dir.path()).entryInfoList({"*.jar"}, QDir::Files)) hashes.append(hashFile(jar.filePath(), QCryptographicHash::Sha1));
+    QHash<QString, QJsonObject> installed = bench.modrinth.getVersionsByHash(hashes, "sha1");
+    QHash<QString, QJsonObject> latest = bench.modrinth.getLatestVersionsByHash(hashes, "sha1", LOADER, GAME_VERSION);
+    QStringList projectIds;
+    for (const auto& version : installed) projectIds.append(version["project_id"].toString());
+    QHash<QString, QString> names = bench.modrinth.getProjectTitles(projectIds);
+    return bench.finish({{"jars", jars}, {"identified", int(installed.size())}, {"withUpdates", int(latest.size())}, {"named", int(names.size())}});
+}
+
+// Look up projects through the app's rate limiter against a server that enforces a per-minute budget. The
+// limiter should keep 429s rare and settle at the server's rate rather than the client's starting guess.
+static QJsonObject rateLimitedLookups(Bench& bench, int lookups) {
+    QStringList titles = bench.server.addSyntheticProjects(lookups, LOADER, GAME_VERSION);
+    if (bench.options.rateLimit <= 0) bench.options.rateLimit = SERVER_CALLS_PER_MINUTE;
+    if (!bench.begin()) return {};
+    bench.limitRequests();
+    QList<QFuture<HttpResponse>> replies;
+    for (const QString& title : titles) replies.append(bench.modrinth.request(QUrl(bench.server.apiBase() + "/project/" + title.toLower().replace(' ', '-'))));
+    int failed = 0;
+    for (auto& reply : replies) failed += reply.result().ok() ? 0 : 1;
+    return bench.finish({{"lookups", lookups}, {"serverLimitPerMinute", bench.options.rateLimit}, {"failed", failed}});
+}
+
+// Download the same batch once per concurrency cap and report throughput for each, to pick the setting.
+// Above QNetworkAccessManager's six connections per host, extra slots only queue inside the engine.
+static QJsonObject downloadSweep(Bench& bench, int files, qint64 fileSize) {
+    bench.server.addSyntheticProjects(files, LOADER, GAME_VERSION, fileSize);
+    if (bench.options.downloadRate <= 0) bench.options.downloadRate = SWEEP_BYTES_PER_SECOND;
+    if (!bench.begin()) return {};
+    QList<ModRef> refs;
+    for (int i = 0; i < files; ++i) refs.append({QString("P%1").arg(i, 7, 10, QChar('0')), QString()});
+    QList<ModInfo> mods = bench.modrinth.getModInfos(refs, LOADER, GAME_VERSION).values();
+    QJsonArray runs;
+    int bestConcurrency = 0;
+    double bestRate = 0;
+    for (int concurrency : {1, 2, 4, 6, 8, 16}) {
+        QTemporaryDir dir;
+        QElapsedTimer timer;
+        timer.start();
+        int failed = bench.download(mods, dir.path(), concurrency, concurrency);
+        qint64 ms = qMax<qint64>(1, timer.elapsed());
+        double mbPerSecond = double(mods.size()) * fileSize / (1024.0 * 1024.0) / (ms / 1000.0);
+        runs.append(QJsonObject{{"concurrency", concurrency}, {"wallMs", ms}, {"mbPerSecond", mbPerSecond}, {"failedDownloads", failed}});
+        if (failed == 0 && mbPerSecond > bestRate) {
+            bestRate = mbPerSecond;
+            bestConcurrency = concurrency;
+        }
+    }
+    return bench.finish({{"files", int(mods.size())}, {"fileSize", fileSize}, {"downloadRate", bench.options.downloadRate}, {"runs", runs},
+                         {"bestConcurrency", bestConcurrency}});
+}
+
+// Build a name index over a 10k-project corpus and time exact lookups, acronym hints and hints for names with
+// a typo. No network involved; the server only supplies the synthetic catalogue.
+static QJsonObject nameIndexLookups(Bench& bench, int projects, int queries) {
+    QStringList titles = bench.server.addSyntheticProjects(projects, LOADER, GAME_VERSION);
+    if (!bench.begin()) return {};
+    QElapsedTimer timer;
+    timer.start();
+    NameIndex index;
+    QStringList ids;
+    for (const QString& title : titles) {
+        const MockModrinthServer::Project* project = bench.server.project(title.toLower().replace(' ', '-'));
+        index.add({project->id, project->slug, project->title, project->downloads, {}});
+        ids.append(project->id);
+    }
+    qint64 buildMs = timer.elapsed();
+    auto run = [&](const std::function<QString(const QString&)>& query, const std::function<QStringList(const QString&)>& ask) {
+        int hits = 0;
+        qint64 nanoseconds = 0;
+        for (int q = 0; q < queries; ++q) {
+            int i = int(qint64(q) * projects / queries);
+            QString name = query(titles[i]);
+            timer.restart();
+            QStringList found = ask(name);
+            nanoseconds += timer.nsecsElapsed();
+            hits += found.contains(ids[i]) ? 1 : 0;
+        }
+        return QJsonObject{{"usPerQuery", nanoseconds / 1000.0 / queries}, {"hitRate", double(hits) / queries}};
+    };
+    auto exact = [&index](const QString& name) { return index.lookup(name); };
+    auto hints = [&index](const QString& name) { return index.suggest(name); };
+    auto acronym = [](const QString& title) {
+        QString letters;
+        for (const QString& word : title.split(' ')) letters.append(word[0]);
+        return letters;
+    };
+    auto typo = [](const QString& title) { return QString(title).remove(title.size() / 2, 1); };
+    return bench.finish({{"entries", projects}, {"queries", queries}, {"buildMs", buildMs},
+                         {"exactTitle", run([](const QString& title) { return title; }, exact)}, {"acronymHint", run(acronym, hints)},
+                         {"typoHint", run(typo, hints)}});
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QMap<QString, std::function<QJsonObject(Bench&)>> scenarios{
+        {"search-100", [](Bench& b) { return searchPack(b, 100); }},
+        {"search-500", [](Bench& b) { return searchPack(b, 500); }},
+        {"search-1000", [](Bench& b) { return searchPack(b, 1000); }},
+        {"deep-chain", [](Bench& b) { return dependencyTree(b, 50, 1); }},
+        {"wide-tree", [](Bench& b) { return dependencyTree(b, 4, 6); }},
+        // 1 + 31 + 961 = 993 mods.
+        {"closure-1000", [](Bench& b) { return closureCost(b, 3, 31); }},
+        {"import-250", [](Bench& b) { return importJars(b, 250); }},
+        {"ratelimit-500", [](Bench& b) { return rateLimitedLookups(b, 500); }},
+        {"download-sweep", [](Bench& b) { return downloadSweep(b, 200, 256 * 1024); }},
+        {"name-index-10k", [](Bench& b) { return nameIndexLookups(b, 10000, 1000); }},
+    };
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs CraftPacker scenarios against a local stand-in for the Modrinth API and prints one JSON line each.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("scenario", "Scenarios to run; all of them when none are given: " + scenarios.keys().join(", ") + ".");
+    QCommandLineOption latencyOption("latency", "Server delay before every answer, in milliseconds.", "ms", "20");
+    QCommandLineOption rateLimitOption("rate-limit", "API requests the server allows per minute; 0 for no limit.", "n", "0");
+    QCommandLineOption failOption("fail-every", "Fail every n-th API request with 500; 0 for never.", "n", "0");
+    QCommandLineOption downloadRateOption("download-rate", "Bytes per second per download; 0 for unthrottled, or 1 MiB/s in download-sweep.", "bytes", "0");
+    parser.addOptions({latencyOption, rateLimitOption, failOption, downloadRateOption});
+    parser.process(app);
+
+    BenchOptions options;
+    options.latencyMs = parser.value(latencyOption).toInt();
+    options.rateLimit = parser.value(rateLimitOption).toInt();
+    options.failEvery = parser.value(failOption).toInt();
+    options.downloadRate = parser.value(downloadRateOption).toLongLong();
+    QStringList selected = parser.positionalArguments().isEmpty() ? scenarios.keys() : parser.positionalArguments();
+    for (const QString& name : selected) {
+        if (!scenarios.contains(name)) {
+            QTextStream(stderr) << "Unknown scenario " << name << Qt::endl;
+            return 1;
+        }
+    }
+    QTextStream out(stdout);
+    for (const QString& name : selected) {
+        Bench bench(options);
+        QJsonObject result = scenarios[name](bench);
+        if (result.isEmpty()) {
+            QTextStream(stderr) << "Cannot start the stand-in server for " << name << Qt::endl;
+            return 1;
+        }
+        result["scenario"] = name;
+        out << QJsonDocument(result).toJson(QJsonDocument::Compact) << Qt::endl;
+    }
+    return 0;
+}
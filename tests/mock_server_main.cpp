@@ -0,0 +1,56 @@
+#include "MockModrinthServer.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+
+// Serves a synthetic catalogue until killed, so craftpacker-cli (or the GUI) can be pointed at it with --api-base.
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Local stand-in for the Modrinth API with a synthetic catalogue.");
+    parser.addHelpOption();
+    QCommandLineOption portOption("port", "Port to listen on; 0 picks a free one.", "port", "8080");
+    QCommandLineOption projectsOption("projects", "Synthetic projects to serve.", "n", "1000");
+    QCommandLineOption loaderOption("loader", "Loader every synthetic version is built for.", "loader", "fabric");
+    QCommandLineOption versionOption("mc-version", "Game version every synthetic version is built for.", "version", "1.20.1");
+    QCommandLineOption fileSizeOption("file-size", "Size of each jar in bytes.", "bytes", "16384");
+    QCommandLineOption treeOption("tree", "Also serve a dependency tree rooted at tree-0-0, as depth:fanout.", "depth:fanout");
+    QCommandLineOption latencyOption("latency", "Delay before every answer, in milliseconds.", "ms", "0");
+    QCommandLineOption rateLimitOption("rate-limit", "API requests allowed per minute before answering 429; 0 for none.", "n", "0");
+    QCommandLineOption failOption("fail-every", "Fail every n-th API request with 500; 0 for never.", "n", "0");
+    QCommandLineOption downloadRateOption("download-rate", "Bytes per second per download; 0 for unthrottled.", "bytes", "0");
+    QCommandLineOption modlistOption("write-modlist", "Write the synthetic titles to this file, one per line.", "file");
+    parser.addOptions({portOption, projectsOption, loaderOption, versionOption, fileSizeOption, treeOption, latencyOption, rateLimitOption,
+                       failOption, downloadRateOption, modlistOption});
+    parser.process(app);
+
+    MockModrinthServer server;
+    QString loader = parser.value(loaderOption);
+    QString gameVersion = parser.value(versionOption);
+    QStringList titles = server.addSyntheticProjects(parser.value(projectsOption).toInt(), loader, gameVersion, parser.value(fileSizeOption).toLongLong());
+    if (parser.isSet(treeOption)) {
+        QStringList shape = parser.value(treeOption).split(':');
+        titles.append(server.addDependencyTree("tree", shape.value(0).toInt(), qMax(1, shape.value(1).toInt()), loader, gameVersion));
+    }
+    server.setLatencyMs(parser.value(latencyOption).toInt());
+    server.setRateLimitPerMinute(parser.value(rateLimitOption).toInt());
+    server.setFailEvery(parser.value(failOption).toInt());
+    server.setDownloadBytesPerSecond(parser.value(downloadRateOption).toLongLong());
+    if (parser.isSet(modlistOption)) {
+        QFile modlist(parser.value(modlistOption));
+        if (!modlist.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            QTextStream(stderr) << "Cannot write " << modlist.fileName() << Qt::endl;
+            return 1;
+        }
+        modlist.write(titles.join('\n').toUtf8() + '\n');
+    }
+    if (!server.start(quint16(parser.value(portOption).toUInt()))) {
+        QTextStream(stderr) << "Cannot listen on port " << parser.value(portOption) << Qt::endl;
+        return 1;
+    }
+    QTextStream(stdout) << server.apiBase() << Qt::endl;
+    return app.exec();
+}
@@ -0,0 +1,49 @@
+#include "MockModrinthServer.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTest>
+
+const QString LOADER = "fabric";
+const QString GAME_VERSION = "1.20.1";
+
+// Runs the craftpacker-cli binary built alongside the tests (path passed in as CRAFTPACKER_CLI).
+class tst_Cli : public QObject {
+    Q_OBJECT
+
+private slots:
+    void writeLockRefusedAfterDeadline();
+};
+
+// Against a server that never answers, the deadline ends the run with nothing resolved. Writing that out as a
+// lockfile would pin an empty pack, so the CLI refuses and fails instead.
+void tst_Cli::writeLockRefusedAfterDeadline() {
+    MockModrinthServer server;
+    QStringList names = server.addSyntheticProjects(5, LOADER, GAME_VERSION);
+    server.setStallPrefix("/v2/");
+    QVERIFY(server.start());
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile modList(dir.filePath("mods.txt"));
+    QVERIFY(modList.open(QIODevice::WriteOnly | QIODevice::Text));
+    modList.write(names.join('\n').toUtf8());
+    modList.close();
+
+    QString lockPath = dir.filePath("pack.lock.json");
+    QProcess cli;
+    QElapsedTimer timer;
+    timer.start();
+    cli.start(CRAFTPACKER_CLI, {modList.fileName(), "-m", GAME_VERSION, "-l", LOADER, "--resolve-only", "--deadline", "1",
+                                "--api-base", server.apiBase(), "--data-dir", dir.filePath("data"), "--write-lock", lockPath,
+                                "--report", dir.filePath("report.json")});
+    QVERIFY(cli.waitForFinished(30000));
+    QVERIFY2(timer.elapsed() < 15000, qPrintable(QString::number(timer.elapsed())));
+    QCOMPARE(cli.exitStatus(), QProcess::NormalExit);
+    QVERIFY(cli.exitCode() != 0);
+    QVERIFY(!QFile::exists(lockPath));
+}
+
+QTEST_GUILESS_MAIN(tst_Cli)
+#include "tst_cli.moc"
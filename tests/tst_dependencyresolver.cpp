@@ -0,0 +1,64 @@
+#include "DependencyResolver.h"
+#include "MockModrinthServer.h"
+
+#include <QElapsedTimer>
+#include <QTest>
+
+const QString LOADER = "fabric";
+const QString GAME_VERSION = "1.20.1";
+const int LATENCY_MS = 20;
+
+class tst_DependencyResolver : public QObject {
+    Q_OBJECT
+
+private slots:
+    void syntheticGraph_data();
+    void syntheticGraph();
+};
+
+void tst_DependencyResolver::syntheticGraph_data() {
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<int>("fanout");
+    QTest::newRow("chain-3") << 3 << 1;
+    QTest::newRow("chain-6") << 6 << 1;
+    QTest::newRow("chain-12") << 12 << 1;
+    QTest::newRow("tree-3x4") << 3 << 4;
+    QTest::newRow("tree-4x4") << 4 << 4;
+    QTest::newRow("tree-3x8") << 3 << 8;
+}
+
+// Every mod below the root also requires the root, so each graph has cycles. A level costs a fixed number of
+// round trips however wide it is, so wall time follows depth and not the number of mods.
+void tst_DependencyResolver::syntheticGraph() {
+    QFETCH(int, depth);
+    QFETCH(int, fanout);
+    MockModrinthServer server;
+    QString rootId = server.addDependencyTree("tree", depth, fanout, LOADER, GAME_VERSION);
+    server.setLatencyMs(LATENCY_MS);
+    QVERIFY(server.start());
+    HttpEngine http;
+    ModrinthClient modrinth(&http);
+    modrinth.setApiBase(server.apiBase());
+    std::optional<ModInfo> root = modrinth.getModInfo(rootId, LOADER, GAME_VERSION);
+    QVERIFY(root);
+    server.resetCounters();
+
+    QElapsedTimer timer;
+    timer.start();
+    ResolutionResult result = DependencyResolver(&modrinth).resolve({*root}, LOADER, GAME_VERSION);
+    qint64 wall = timer.elapsed();
+
+    int mods = 0;
+    for (int level = 0, width = 1; level < depth; ++level, width *= fanout) mods += width;
+    qInfo("depth %d, fan-out %d: %d mods in %lld ms with %lld requests", depth, fanout, mods, wall, server.requestCount());
+    QCOMPARE(int(result.downloadQueue.size()), mods);
+    QCOMPARE(result.levels, depth);
+    QVERIFY(result.unresolved.isEmpty());
+    // Deepest first, so the root downloads last.
+    QCOMPARE(result.downloadQueue.last().projectId, rootId);
+    QVERIFY(server.requestCount() <= 4 * depth);
+    QVERIFY2(wall < 3 * 2 * LATENCY_MS * depth + 500, qPrintable(QString("took %1 ms").arg(wall)));
+}
+
+QTEST_GUILESS_MAIN(tst_DependencyResolver)
+#include "tst_dependencyresolver.moc"
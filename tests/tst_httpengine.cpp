@@ -0,0 +1,73 @@
+#include "HttpEngine.h"
+#include "MockModrinthServer.h"
+#include "ModSearch.h"
+
+#include <QElapsedTimer>
+#include <QTest>
+#include <QThreadPool>
+#include <vector>
+
+const QString LOADER = "fabric";
+const QString GAME_VERSION = "1.20.1";
+// QNetworkAccessManager opens at most this many HTTP/1.1 connections per host.
+const int MAX_CONNECTIONS_PER_HOST = 6;
+
+class tst_HttpEngine : public QObject {
+    Q_OBJECT
+
+private slots:
+    void searchReusesConnections();
+    void callbackRunsOnContextThread();
+};
+
+// A 300-mod search from many pool threads must share the engine's keep-alive connections instead of opening
+// one per request.
+void tst_HttpEngine::searchReusesConnections() {
+    MockModrinthServer server;
+    QStringList names = server.addSyntheticProjects(300, LOADER, GAME_VERSION);
+    server.setLatencyMs(5);
+    QVERIFY(server.start());
+    HttpEngine http;
+    ModrinthClient modrinth(&http);
+    modrinth.setApiBase(server.apiBase());
+
+    std::vector<ModSearch::Result> results(names.size());
+    QThreadPool pool;
+    pool.setMaxThreadCount(16);
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < names.size(); ++i) {
+        pool.start([&modrinth, &results, &names, i]() { results[i] = ModSearch(&modrinth).find(names.at(i), LOADER, GAME_VERSION); });
+    }
+    pool.waitForDone();
+    qint64 wall = timer.elapsed();
+
+    int found = 0;
+    for (const auto& result : results) found += result.mod ? 1 : 0;
+    QCOMPARE(found, int(names.size()));
+    qInfo("300-mod search: %lld ms, %lld requests over %lld connections", wall, server.requestCount(), server.connectionCount());
+    QVERIFY(server.requestCount() >= names.size());
+    QVERIFY(server.connectionCount() <= MAX_CONNECTIONS_PER_HOST);
+}
+
+void tst_HttpEngine::callbackRunsOnContextThread() {
+    MockModrinthServer server;
+    server.addSyntheticProjects(1, LOADER, GAME_VERSION);
+    QVERIFY(server.start());
+    HttpEngine http;
+    QObject context;
+    QThread* callbackThread = nullptr;
+    int status = 0;
+    bool done = false;
+    http.get(QNetworkRequest(QUrl(server.apiBase() + "/project/P0000000")), &context, [&](const HttpResponse& response) {
+        callbackThread = QThread::currentThread();
+        status = response.statusCode;
+        done = true;
+    });
+    QTRY_VERIFY(done);
+    QCOMPARE(callbackThread, QThread::currentThread());
+    QCOMPARE(status, 200);
+}
+
+QTEST_GUILESS_MAIN(tst_HttpEngine)
+#include "tst_httpengine.moc"
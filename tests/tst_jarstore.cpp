@@ -0,0 +1,68 @@
+#include "FileHash.h"
+#include "JarStore.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+class tst_JarStore : public QObject {
+    Q_OBJECT
+
+private slots:
+    void placeLinksAdoptedFile();
+    void placeRejectsCorruptedBlob();
+};
+
+static ModInfo writeJar(const QString& path, const QByteArray& content) {
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) file.write(content);
+    file.close();
+    ModInfo mod;
+    mod.filename = QFileInfo(path).fileName();
+    mod.size = content.size();
+    mod.sha1 = hashFile(path, QCryptographicHash::Sha1);
+    mod.sha512 = hashFile(path, QCryptographicHash::Sha512);
+    return mod;
+}
+
+void tst_JarStore::placeLinksAdoptedFile() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QDir().mkpath(dir.filePath("pack-a"));
+    ModInfo mod = writeJar(dir.filePath("pack-a/example.jar"), QByteArray(4096, 'x'));
+    JarStore store(dir.filePath("store"));
+    store.adopt(mod, dir.filePath("pack-a/example.jar"));
+
+    QVERIFY(store.place(mod, dir.filePath("pack-b")) != JarStore::Method::None);
+    QVERIFY(fileMatches(dir.filePath("pack-b/example.jar"), mod.size, mod.sha1, mod.sha512));
+    QCOMPARE(store.placedFiles(), qint64(1));
+}
+
+// A blob whose bytes no longer match its name, e.g. a hardlinked pack file edited in place, is not linked into
+// another pack; it is deleted so the next download stores a good copy.
+void tst_JarStore::placeRejectsCorruptedBlob() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QDir().mkpath(dir.filePath("pack-a"));
+    ModInfo mod = writeJar(dir.filePath("pack-a/example.jar"), QByteArray(4096, 'x'));
+    JarStore store(dir.filePath("store"));
+    store.adopt(mod, dir.filePath("pack-a/example.jar"));
+
+    QDirIterator blobs(dir.filePath("store/blobs"), QDir::Files, QDirIterator::Subdirectories);
+    QVERIFY(blobs.hasNext());
+    QString blob = blobs.next();
+    QFile::remove(blob);
+    QFile corrupted(blob);
+    QVERIFY(corrupted.open(QIODevice::WriteOnly));
+    corrupted.write(QByteArray(4096, 'y'));
+    corrupted.close();
+
+    QCOMPARE(store.place(mod, dir.filePath("pack-b")), JarStore::Method::None);
+    QVERIFY(!QFile::exists(dir.filePath("pack-b/example.jar")));
+    QVERIFY(!QFile::exists(blob));
+}
+
+QTEST_GUILESS_MAIN(tst_JarStore)
+#include "tst_jarstore.moc"
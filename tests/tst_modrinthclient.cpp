@@ -0,0 +1,123 @@
+#include "MockModrinthServer.h"
+#include "ModrinthClient.h"
+
+#include <QElapsedTimer>
+#include <QTest>
+#include <QThreadPool>
+
+const QString LOADER = "fabric";
+const QString GAME_VERSION = "1.20.1";
+const QString PROJECT = "P0000000";
+
+// Every test stalls the project endpoint, so a request only ends when a caller's token ends it.
+class tst_ModrinthClient : public QObject {
+    Q_OBJECT
+
+private slots:
+    void joinerKeepsItsOwnDeadline();
+    void sharedRequestOutlivesFirstCaller();
+    void joinerRetriesWhenFirstCallerCancels();
+};
+
+// The joiner's deadline is shorter than the first caller's and must still release it on time.
+void tst_ModrinthClient::joinerKeepsItsOwnDeadline() {
+    MockModrinthServer server;
+    server.addSyntheticProjects(1, LOADER, GAME_VERSION);
+    server.setStallPrefix("/v2/project/" + PROJECT);
+    QVERIFY(server.start());
+    HttpEngine http;
+    ModrinthClient modrinth(&http);
+    modrinth.setApiBase(server.apiBase());
+    QUrl url(server.apiBase() + "/project/" + PROJECT);
+
+    CancellationToken firstToken = CancellationToken::create(QDeadlineTimer(10000));
+    CancellationToken joinerToken = CancellationToken::create(QDeadlineTimer(300));
+    QFuture<HttpResponse> first, joined;
+    {
+        CancellationScope scope(firstToken);
+        first = modrinth.request(url);
+    }
+    {
+        CancellationScope scope(joinerToken);
+        joined = modrinth.request(url);
+    }
+    QCOMPARE(modrinth.coalescedCount(), qint64(1));
+    QElapsedTimer timer;
+    timer.start();
+    QCOMPARE(joined.result().error, QNetworkReply::OperationCanceledError);
+    QVERIFY2(timer.elapsed() < 3000, qPrintable(QString::number(timer.elapsed())));
+    QVERIFY(!first.isFinished());
+    firstToken.cancel();
+    QCOMPARE(first.result().error, QNetworkReply::OperationCanceledError);
+}
+
+// Cancelling the caller that started a request answers only that caller; the request is aborted once the
+// last waiter leaves, and the next call goes back to the network instead of joining it.
+void tst_ModrinthClient::sharedRequestOutlivesFirstCaller() {
+    MockModrinthServer server;
+    server.addSyntheticProjects(1, LOADER, GAME_VERSION);
+    server.setStallPrefix("/v2/project/" + PROJECT);
+    QVERIFY(server.start());
+    HttpEngine http;
+    ModrinthClient modrinth(&http);
+    modrinth.setApiBase(server.apiBase());
+    QUrl url(server.apiBase() + "/project/" + PROJECT);
+
+    CancellationToken firstToken = CancellationToken::create();
+    CancellationToken joinerToken = CancellationToken::create();
+    QFuture<HttpResponse> first, joined;
+    {
+        CancellationScope scope(firstToken);
+        first = modrinth.request(url);
+    }
+    {
+        CancellationScope scope(joinerToken);
+        joined = modrinth.request(url);
+    }
+    QTRY_COMPARE(server.requestCount(), qint64(1));
+    firstToken.cancel();
+    QCOMPARE(first.result().error, QNetworkReply::OperationCanceledError);
+    QTest::qWait(200);
+    QVERIFY(!joined.isFinished());
+
+    joinerToken.cancel();
+    QCOMPARE(joined.result().error, QNetworkReply::OperationCanceledError);
+    server.setStallPrefix(QString());
+    HttpResponse fresh = modrinth.request(url).result();
+    QCOMPARE(fresh.statusCode, 200);
+    QCOMPARE(modrinth.coalescedCount(), qint64(1));
+    QCOMPARE(server.requestCount(), qint64(2));
+}
+
+// getModInfo runs under the first caller's token. When that token cuts it short, a joiner whose own token is
+// still live looks the project up again rather than reporting it missing.
+void tst_ModrinthClient::joinerRetriesWhenFirstCallerCancels() {
+    MockModrinthServer server;
+    server.addSyntheticProjects(1, LOADER, GAME_VERSION);
+    server.setStallPrefix("/v2/project/" + PROJECT);
+    QVERIFY(server.start());
+    HttpEngine http;
+    ModrinthClient modrinth(&http);
+    modrinth.setApiBase(server.apiBase());
+
+    CancellationToken firstToken = CancellationToken::create();
+    std::optional<ModInfo> firstInfo, joinedInfo;
+    QThreadPool pool;
+    pool.start([&]() {
+        CancellationScope scope(firstToken);
+        firstInfo = modrinth.getModInfo(PROJECT, LOADER, GAME_VERSION);
+    });
+    QTRY_COMPARE(server.requestCount(), qint64(1));
+    pool.start([&]() { joinedInfo = modrinth.getModInfo(PROJECT, LOADER, GAME_VERSION); });
+    QTRY_COMPARE(modrinth.coalescedCount(), qint64(1));
+
+    server.setStallPrefix(QString());
+    firstToken.cancel();
+    pool.waitForDone();
+    QVERIFY(!firstInfo);
+    QVERIFY(joinedInfo);
+    QCOMPARE(joinedInfo->projectId, PROJECT);
+}
+
+QTEST_GUILESS_MAIN(tst_ModrinthClient)
+#include "tst_modrinthclient.moc"
@@ -0,0 +1,83 @@
+#include "MockModrinthServer.h"
+#include "ModSearch.h"
+
+#include <QTest>
+#include <memory>
+
+const QString LOADER = "fabric";
+const QString GAME_VERSION = "1.20.1";
+
+static MockModrinthServer::Project project(const QString& id, const QString& slug, const QString& title, qint64 downloads) {
+    MockModrinthServer::Project p;
+    p.id = id;
+    p.slug = slug;
+    p.title = title;
+    p.downloads = downloads;
+    MockModrinthServer::Version version;
+    version.id = "v-" + id;
+    version.loaders = {LOADER};
+    version.gameVersions = {GAME_VERSION};
+    p.versions.append(version);
+    return p;
+}
+
+class tst_ModSearch : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void exactNameSkipsSearch();
+    void acronymIsOnlyAHint();
+    void hintsReorderSearchHits();
+
+private:
+    std::unique_ptr<MockModrinthServer> server;
+    std::unique_ptr<HttpEngine> http;
+    std::unique_ptr<ModrinthClient> modrinth;
+    std::unique_ptr<NameIndex> index;
+};
+
+// Just Enough Items is what "jei" means on Modrinth, but the index only knows Jolly Extra Ingots, whose acronym
+// is also "jei" and which has more downloads. Jolly Extras is only on the server.
+void tst_ModSearch::init() {
+    server = std::make_unique<MockModrinthServer>();
+    server->addProject(project("JEI00001", "jei", "Just Enough Items", 1000));
+    server->addProject(project("JOLLY001", "jolly-extra-ingots", "Jolly Extra Ingots", 5000));
+    server->addProject(project("SODIUM01", "sodium", "Sodium", 9000));
+    server->addProject(project("JOLLYEX2", "jolly-extras", "Jolly Extras", 10000));
+    QVERIFY(server->start());
+    http = std::make_unique<HttpEngine>();
+    modrinth = std::make_unique<ModrinthClient>(http.get());
+    modrinth->setApiBase(server->apiBase());
+    index = std::make_unique<NameIndex>();
+    index->add({"JOLLY001", "jolly-extra-ingots", "Jolly Extra Ingots", 5000, {}});
+    index->add({"SODIUM01", "sodium", "Sodium", 9000, {}});
+}
+
+void tst_ModSearch::exactNameSkipsSearch() {
+    ModSearch::Result result = ModSearch(modrinth.get(), index.get()).find("Sodium", LOADER, GAME_VERSION);
+    QVERIFY(result.mod);
+    QCOMPARE(result.mod->projectId, QString("SODIUM01"));
+    QCOMPARE(result.status, QString("Available (Index)"));
+}
+
+void tst_ModSearch::acronymIsOnlyAHint() {
+    ModSearch::Result result = ModSearch(modrinth.get(), index.get()).find("jei", LOADER, GAME_VERSION);
+    QVERIFY(result.mod);
+    QCOMPARE(result.mod->projectId, QString("JEI00001"));
+    QCOMPARE(result.status, QString("Available (API)"));
+    // What /search confirmed is learned as an alias, so the next lookup is exact.
+    QCOMPARE(index->lookup("jei"), QStringList{"JEI00001"});
+}
+
+// /search ranks Jolly Extras first by downloads; the index's near match puts Jolly Extra Ingots ahead of it.
+void tst_ModSearch::hintsReorderSearchHits() {
+    QCOMPARE(index->suggest("Jolly Extra"), QStringList{"JOLLY001"});
+    ModSearch::Result result = ModSearch(modrinth.get(), index.get()).find("Jolly Extra", LOADER, GAME_VERSION);
+    QVERIFY(result.mod);
+    QCOMPARE(result.mod->projectId, QString("JOLLY001"));
+    QCOMPARE(result.status, QString("Available (API)"));
+}
+
+QTEST_GUILESS_MAIN(tst_ModSearch)
+#include "tst_modsearch.moc"
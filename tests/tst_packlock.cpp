@@ -0,0 +1,58 @@
+#include "PackLock.h"
+#include "Zip.h"
+
+#include <QTemporaryDir>
+#include <QTest>
+
+static QJsonObject lockWith(const QString& filename) {
+    QJsonObject mod{{"name", "Sodium"}, {"projectId", "AANobbMI"}, {"versionId", "abc"}, {"filename", filename},
+                    {"url", "https://cdn.modrinth.com/data/AANobbMI/versions/abc/" + filename}, {"size", 10}};
+    return QJsonObject{{"formatVersion", 1}, {"gameVersion", "1.20.1"}, {"loader", "fabric"}, {"mods", QJsonArray{mod}}};
+}
+
+class tst_PackLock : public QObject {
+    Q_OBJECT
+
+private slots:
+    void lockFilename_data();
+    void lockFilename();
+    void mrpackSkipsUnsafePaths();
+};
+
+void tst_PackLock::lockFilename_data() {
+    QTest::addColumn<QString>("filename");
+    QTest::addColumn<bool>("accepted");
+    QTest::newRow("plain") << "sodium-0.5.3.jar" << true;
+    QTest::newRow("empty") << "" << false;
+    QTest::newRow("parent") << "../sodium.jar" << false;
+    QTest::newRow("dot-dot") << ".." << false;
+    QTest::newRow("subdirectory") << "mods/sodium.jar" << false;
+    QTest::newRow("backslash") << "..\\sodium.jar" << false;
+    QTest::newRow("absolute") << "/etc/cron.d/sodium" << false;
+    QTest::newRow("drive") << "C:\\Windows\\sodium.jar" << false;
+    QTest::newRow("drive relative") << "C:sodium.jar" << false;
+}
+
+void tst_PackLock::lockFilename() {
+    QFETCH(QString, filename);
+    QFETCH(bool, accepted);
+    QCOMPARE(PackLock::fromJson(lockWith(filename)).has_value(), accepted);
+}
+
+void tst_PackLock::mrpackSkipsUnsafePaths() {
+    QJsonArray files;
+    for (const QString& path : {"mods/sodium.jar", "mods/../evil.jar", "mods/sub/evil.jar", "mods/..\\evil.jar", "config/evil.jar"}) {
+        files.append(QJsonObject{{"path", path}, {"downloads", QJsonArray{"https://cdn.modrinth.com/data/A/versions/B/x.jar"}}, {"fileSize", 1}});
+    }
+    QJsonObject index{{"formatVersion", 1}, {"game", "minecraft"}, {"name", "pack"}, {"files", files}, {"dependencies", QJsonObject{{"minecraft", "1.20.1"}}}};
+    QTemporaryDir dir;
+    QString path = dir.filePath("pack.mrpack");
+    QVERIFY(writeZip(path, {{"modrinth.index.json", QJsonDocument(index).toJson()}}));
+    std::optional<PackLock> lock = PackLock::load(path);
+    QVERIFY(lock);
+    QCOMPARE(int(lock->mods.size()), 1);
+    QCOMPARE(lock->mods.first().filename, QString("sodium.jar"));
+}
+
+QTEST_GUILESS_MAIN(tst_PackLock)
+#include "tst_packlock.moc"
@@ -0,0 +1,106 @@
+#include "DownloadScheduler.h"
+#include "ResultsModel.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QTableView>
+#include <QTest>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+const int DOWNLOADS = 500;
+const qint64 FILE_SIZE = 4 * 1024 * 1024;
+const qint64 CHUNK = 16 * 1024;
+const int WRITER_THREADS = 4;
+// The same refresh rate CraftPacker polls download progress at.
+const int REFRESH_MS = 33;
+const int PROBE_MS = 1;
+
+class tst_ProgressStress : public QObject {
+    Q_OBJECT
+
+private slots:
+    void concurrentDownloads();
+};
+
+// 500 transfers report progress the way the network thread does, through lock-free counters bumped once per
+// chunk, while the GUI thread polls them at about 30 Hz and updates a model shown in a view. A 1 ms probe timer
+// measures how late the event loop gets to it.
+void tst_ProgressStress::concurrentDownloads() {
+    ResultsModel model({"Mod Name", "Status", "Progress"});
+    QTableView view;
+    view.setModel(&model);
+    view.resize(800, 600);
+    view.show();
+    std::vector<std::shared_ptr<TransferProgress>> transfers;
+    for (int i = 0; i < DOWNLOADS; ++i) {
+        model.append(QString("mod-%1").arg(i), QString("P%1").arg(i), QString("Mod %1").arg(i), "Downloading", ResultRow::Tag::Found);
+        transfers.push_back(std::make_shared<TransferProgress>());
+        transfers.back()->total.storeRelaxed(FILE_SIZE);
+    }
+
+    std::atomic<bool> running{true};
+    std::vector<std::thread> writers;
+    for (int w = 0; w < WRITER_THREADS; ++w) {
+        writers.emplace_back([&transfers, &running, w]() {
+            bool pending = true;
+            while (running && pending) {
+                pending = false;
+                for (int i = w; i < DOWNLOADS; i += WRITER_THREADS) {
+                    qint64 received = transfers[i]->received.loadRelaxed();
+                    if (received >= FILE_SIZE) continue;
+                    transfers[i]->received.storeRelaxed(std::min(FILE_SIZE, received + CHUNK));
+                    pending = true;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+
+    std::vector<qint64> reported(DOWNLOADS, -1);
+    int completed = 0;
+    QTimer refresh;
+    refresh.setInterval(REFRESH_MS);
+    connect(&refresh, &QTimer::timeout, [&]() {
+        for (int i = 0; i < DOWNLOADS; ++i) {
+            qint64 received = transfers[i]->received.loadRelaxed();
+            if (received == reported[i]) continue;
+            reported[i] = received;
+            model.setProgress(model.find(QString("mod-%1").arg(i)), int(received * 100 / FILE_SIZE));
+            if (received == FILE_SIZE) ++completed;
+        }
+    });
+    std::vector<qint64> lateness;
+    QElapsedTimer sinceProbe;
+    QTimer probe;
+    probe.setTimerType(Qt::PreciseTimer);
+    probe.setInterval(PROBE_MS);
+    connect(&probe, &QTimer::timeout, [&]() {
+        lateness.push_back(qMax<qint64>(0, sinceProbe.restart() - PROBE_MS));
+    });
+
+    QElapsedTimer wall;
+    wall.start();
+    sinceProbe.start();
+    refresh.start();
+    probe.start();
+    QTRY_VERIFY_WITH_TIMEOUT(completed == DOWNLOADS, 60000);
+    probe.stop();
+    refresh.stop();
+    running = false;
+    for (auto& writer : writers) writer.join();
+
+    QVERIFY(!lateness.empty());
+    std::sort(lateness.begin(), lateness.end());
+    qint64 p50 = lateness[lateness.size() / 2];
+    qint64 p99 = lateness[lateness.size() * 99 / 100];
+    qInfo("%d downloads in %lld ms; event-loop lateness p50 %lld ms, p99 %lld ms, max %lld ms over %zu probes",
+          DOWNLOADS, wall.elapsed(), p50, p99, lateness.back(), lateness.size());
+    QVERIFY2(p99 < REFRESH_MS, qPrintable(QString("p99 lateness %1 ms").arg(p99)));
+}
+
+QTEST_MAIN(tst_ProgressStress)
+#include "tst_progressstress.moc"
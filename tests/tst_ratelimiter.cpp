@@ -0,0 +1,91 @@
+#include "HttpEngine.h"
+#include "MockModrinthServer.h"
+#include "RateLimiter.h"
+
+#include <QTest>
+
+using namespace std::chrono;
+
+const QString LOADER = "fabric";
+const QString GAME_VERSION = "1.20.1";
+const QString PROJECT = "P0000000";
+
+class tst_RateLimiter : public QObject {
+    Q_OBJECT
+
+private slots:
+    void burstThenWait();
+    void headersRaiseAndLowerRate();
+    void rateLimitedRequestsRetry();
+    void highPriorityJumpsQueue();
+};
+
+void tst_RateLimiter::burstThenWait() {
+    RateLimiter limiter(60, 3);
+    for (int i = 0; i < 3; ++i) QCOMPARE(limiter.tryAcquire(), milliseconds(0));
+    milliseconds wait = limiter.tryAcquire();
+    QVERIFY(wait > milliseconds(900) && wait <= milliseconds(1000));
+}
+
+// The header budget replaces the current rate in both directions, 5% under what the server allows.
+void tst_RateLimiter::headersRaiseAndLowerRate() {
+    RateLimiter limiter(60, 1);
+    QCOMPARE(limiter.tryAcquire(), milliseconds(0));
+    limiter.updateFromHeaders(6000, 100, 60);
+    milliseconds wait = limiter.tryAcquire();
+    QVERIFY2(wait <= milliseconds(11), qPrintable(QString::number(wait.count())));
+    limiter.updateFromHeaders(60, 100, 60);
+    wait = limiter.tryAcquire();
+    QVERIFY2(wait > milliseconds(900), qPrintable(QString::number(wait.count())));
+}
+
+// A burst well over the server's budget is answered partly with 429. Each of those waits out Retry-After plus
+// jitter and is sent again, so every request ends in a 200, and the limiter follows the server's headers closely
+// enough that only a few requests are turned away more than once.
+void tst_RateLimiter::rateLimitedRequestsRetry() {
+    const int REQUESTS = 10;
+    MockModrinthServer server;
+    server.addSyntheticProjects(1, LOADER, GAME_VERSION);
+    // Two requests per one-second window.
+    server.setRateLimitPerMinute(120);
+    server.setRateWindowMs(1000);
+    QVERIFY(server.start());
+    RateLimiter limiter(6000, REQUESTS);
+    HttpEngine http;
+    http.setRateLimiter("127.0.0.1", &limiter);
+
+    QList<QFuture<HttpResponse>> replies;
+    for (int i = 0; i < REQUESTS; ++i) replies.append(http.get(QNetworkRequest(QUrl(server.apiBase() + "/project/" + PROJECT))));
+    for (auto& reply : replies) QCOMPARE(reply.result().statusCode, 200);
+    QVERIFY(server.rateLimitedCount() > 0);
+    QVERIFY2(server.rateLimitedCount() <= 2 * REQUESTS, qPrintable(QString::number(server.rateLimitedCount())));
+}
+
+// While the limiter holds back a queue of low-priority requests, a high-priority one takes the next token.
+void tst_RateLimiter::highPriorityJumpsQueue() {
+    const int LOW_REQUESTS = 20;
+    MockModrinthServer server;
+    server.addSyntheticProjects(1, LOADER, GAME_VERSION);
+    QVERIFY(server.start());
+    RateLimiter limiter(600, 1);
+    HttpEngine http;
+    http.setRateLimiter("127.0.0.1", &limiter);
+    QUrl url(server.apiBase() + "/project/" + PROJECT);
+
+    QList<QFuture<HttpResponse>> low;
+    for (int i = 0; i < LOW_REQUESTS; ++i) {
+        QNetworkRequest request(url);
+        request.setPriority(QNetworkRequest::LowPriority);
+        low.append(http.get(request));
+    }
+    QNetworkRequest request(url);
+    request.setPriority(QNetworkRequest::HighPriority);
+    QCOMPARE(http.get(request).result().statusCode, 200);
+    int finishedLow = 0;
+    for (const auto& reply : low) finishedLow += reply.isFinished();
+    QVERIFY2(finishedLow <= LOW_REQUESTS / 4, qPrintable(QString::number(finishedLow)));
+    for (auto& reply : low) QCOMPARE(reply.result().statusCode, 200);
+}
+
+QTEST_GUILESS_MAIN(tst_RateLimiter)
+#include "tst_ratelimiter.moc"
@@ -0,0 +1,61 @@
+#include "CraftPacker.h"
+#include "MockModrinthServer.h"
+
+#include <QApplication>
+#include <QDir>
+#include <QPushButton>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTest>
+#include <QTextEdit>
+#include <QThreadPool>
+
+const QString LOADER = "fabric";
+const QString GAME_VERSION = "1.20.1";
+
+// Drives the main window against the stand-in server. Test mode keeps its settings and caches out of the
+// user's own, and they are wiped first so every run starts cold.
+class tst_SearchPrefetch : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void searchPrefetchesVisibleDetails();
+};
+
+void tst_SearchPrefetch::initTestCase() {
+    QStandardPaths::setTestModeEnabled(true);
+    QCoreApplication::setOrganizationName("CraftPacker");
+    QCoreApplication::setApplicationName("tst_searchprefetch");
+    QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).removeRecursively();
+    QSettings().clear();
+}
+
+// Search results arrive on the GUI thread, so finishing the search starts the prefetch timer there and the
+// details of the rows on screen are fetched in one /projects batch.
+void tst_SearchPrefetch::searchPrefetchesVisibleDetails() {
+    MockModrinthServer server;
+    QStringList names = server.addSyntheticProjects(20, LOADER, GAME_VERSION);
+    QVERIFY(server.start());
+    QSettings().setValue("apiBase", server.apiBase());
+    {
+        CraftPacker window;
+        window.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&window));
+        auto* modList = window.findChild<QTextEdit*>("modlistInput");
+        auto* searchButton = window.findChild<QPushButton*>("searchButton");
+        QVERIFY(modList);
+        QVERIFY(searchButton);
+        modList->setPlainText(names.join('\n'));
+        QCOMPARE(server.requestCount("/v2/projects"), qint64(0));
+
+        QTest::mouseClick(searchButton, Qt::LeftButton);
+        QTRY_VERIFY_WITH_TIMEOUT(server.requestCount("/v2/projects") > 0, 15000);
+        QThreadPool::globalInstance()->waitForDone();
+        QCoreApplication::processEvents();
+    }
+    QSettings().remove("apiBase");
+}
+
+QTEST_MAIN(tst_SearchPrefetch)
+#include "tst_searchprefetch.moc"
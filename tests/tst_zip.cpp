@@ -0,0 +1,151 @@
+#include "Zip.h"
+
+#include <QDataStream>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTest>
+
+const QByteArray ENTRY = "modrinth.index.json";
+
+// Strips qCompress's length prefix, zlib header and Adler-32 trailer, leaving the raw deflate stream ZIP stores.
+static QByteArray rawDeflate(const QByteArray& data) {
+    QByteArray zlib = qCompress(data, 9);
+    return zlib.mid(6, zlib.size() - 10);
+}
+
+static int firstBlockType(const QByteArray& deflated) {
+    return (quint8(deflated[0]) >> 1) & 3;
+}
+
+// A one-entry archive whose headers say whatever they are told, so broken archives can be built too.
+static QByteArray archive(quint16 method, const QByteArray& payload, quint32 size, quint32 crc) {
+    QByteArray out;
+    QDataStream s(&out, QIODevice::WriteOnly);
+    s.setByteOrder(QDataStream::LittleEndian);
+    s << quint32(0x04034b50) << quint16(20) << quint16(0) << method << quint16(0) << quint16(0) << crc << quint32(payload.size()) << size
+      << quint16(ENTRY.size()) << quint16(0);
+    s.writeRawData(ENTRY.constData(), ENTRY.size());
+    s.writeRawData(payload.constData(), payload.size());
+    quint32 central = quint32(out.size());
+    s << quint32(0x02014b50) << quint16(20) << quint16(20) << quint16(0) << method << quint16(0) << quint16(0) << crc << quint32(payload.size())
+      << size << quint16(ENTRY.size()) << quint16(0) << quint16(0) << quint16(0) << quint16(0) << quint32(0) << quint32(0);
+    s.writeRawData(ENTRY.constData(), ENTRY.size());
+    quint32 centralSize = quint32(out.size()) - central;
+    s << quint32(0x06054b50) << quint16(0) << quint16(0) << quint16(1) << quint16(1) << centralSize << central << quint16(0);
+    return out;
+}
+
+static QByteArray deflatedArchive(const QByteArray& payload, const QByteArray& data) {
+    return archive(8, payload, quint32(data.size()), crc32(data));
+}
+
+// Words from a small vocabulary with skewed frequencies: long enough and uneven enough that zlib picks dynamic codes.
+static QByteArray skewedText(int words) {
+    static const char* const vocabulary[] = {"minecraft", "fabric", "sodium", "lithium", "the", "a", "mod", "loader", "version", "jar"};
+    QRandomGenerator random(42);
+    QByteArray text;
+    for (int i = 0; i < words; ++i) {
+        quint32 r = random.bounded(100u);
+        text += vocabulary[r < 40 ? 4 : r < 60 ? 5 : r % 10];
+        text += (i % 12 == 11) ? '\n' : ' ';
+    }
+    return text;
+}
+
+class tst_Zip : public QObject {
+    Q_OBJECT
+
+private slots:
+    void roundTrip();
+    void storedEntry();
+    void storedBlock();
+    void fixedBlock();
+    void dynamicBlock();
+    void corrupt_data();
+    void corrupt();
+
+private:
+    std::optional<QByteArray> read(const QByteArray& bytes);
+    QTemporaryDir dir;
+};
+
+std::optional<QByteArray> tst_Zip::read(const QByteArray& bytes) {
+    QString path = dir.filePath("test.zip");
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return std::nullopt;
+    file.write(bytes);
+    file.close();
+    return readZipEntry(path, QString::fromLatin1(ENTRY));
+}
+
+void tst_Zip::roundTrip() {
+    QByteArray index = skewedText(2000);
+    QByteArray small = "{}";
+    QString path = dir.filePath("pack.mrpack");
+    QVERIFY(writeZip(path, {{"modrinth.index.json", index}, {"overrides/a.txt", small}}));
+    QCOMPARE(readZipEntry(path, "modrinth.index.json").value_or(QByteArray()), index);
+    QCOMPARE(readZipEntry(path, "overrides/a.txt").value_or(QByteArray()), small);
+    QVERIFY(!readZipEntry(path, "missing"));
+}
+
+void tst_Zip::storedEntry() {
+    QByteArray data = "stored without compression";
+    QCOMPARE(read(archive(0, data, quint32(data.size()), crc32(data))).value_or(QByteArray()), data);
+}
+
+void tst_Zip::storedBlock() {
+    QByteArray data = "a deflate stream made of one stored block";
+    quint16 len = quint16(data.size());
+    QByteArray payload;
+    payload += char(0x01);
+    payload += char(len & 0xFF);
+    payload += char(len >> 8);
+    payload += char(~len & 0xFF);
+    payload += char((~len >> 8) & 0xFF);
+    payload += data;
+    QCOMPARE(read(deflatedArchive(payload, data)).value_or(QByteArray()), data);
+}
+
+void tst_Zip::fixedBlock() {
+    QByteArray data = "fabric fabric fabric sodium";
+    QByteArray payload = rawDeflate(data);
+    QCOMPARE(firstBlockType(payload), 1);
+    QCOMPARE(read(deflatedArchive(payload, data)).value_or(QByteArray()), data);
+}
+
+void tst_Zip::dynamicBlock() {
+    QByteArray data = skewedText(5000);
+    QByteArray payload = rawDeflate(data);
+    QCOMPARE(firstBlockType(payload), 2);
+    QCOMPARE(read(deflatedArchive(payload, data)).value_or(QByteArray()), data);
+}
+
+void tst_Zip::corrupt_data() {
+    QTest::addColumn<QByteArray>("bytes");
+    QByteArray text = skewedText(5000);
+    QByteArray payload = rawDeflate(text);
+    QByteArray zeros(8 * 1024 * 1024, '\0');
+
+    QTest::newRow("not a zip") << QByteArray("PK but not really");
+    QTest::newRow("truncated archive") << deflatedArchive(payload, text).left(100);
+    QTest::newRow("truncated stream") << deflatedArchive(payload.left(payload.size() / 2), text);
+    QTest::newRow("reserved block type") << deflatedArchive(QByteArray("\x07\x00\x00", 3), text);
+    QTest::newRow("stored length check") << deflatedArchive(QByteArray("\x01\x05\x00\x00\x00hello", 10), QByteArray("hello"));
+    QByteArray garbage = payload;
+    for (int i = 1; i < 40; ++i) garbage[i] = char(0xFF);
+    QTest::newRow("bad huffman table") << deflatedArchive(garbage, text);
+    QTest::newRow("bad crc") << archive(8, payload, quint32(text.size()), crc32(text) ^ 1);
+    QTest::newRow("size smaller than data") << archive(8, payload, quint32(text.size() - 1), crc32(text));
+    QTest::newRow("size larger than data") << archive(8, payload, quint32(text.size() + 1), crc32(text));
+    QTest::newRow("stored size mismatch") << archive(0, text, quint32(text.size() + 1), crc32(text));
+    QTest::newRow("bomb") << archive(8, rawDeflate(zeros), 1000, crc32(zeros));
+    QTest::newRow("huge declared size") << archive(8, payload, 0xFFFFFFFFu, crc32(text));
+}
+
+void tst_Zip::corrupt() {
+    QFETCH(QByteArray, bytes);
+    QVERIFY(!read(bytes));
+}
+
+QTEST_GUILESS_MAIN(tst_Zip)
+#include "tst_zip.moc"